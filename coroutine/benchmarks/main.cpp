@@ -7,6 +7,7 @@
 #include <cstddef>
 #include <iomanip>
 #include <iostream>
+#include <type_traits>
 #include <vector>
 
 using namespace std::chrono;
@@ -99,10 +100,12 @@ auto benchmark_ping_pong(int n) -> Coroutine<>
 
 // =====================================================================
 // --- 实验 3: MPMC 吞吐量 (多生产者多消费者) ---
+// T 为 void 时只传递计数；T 为 int 时与 Go 的 chan int 对标，走带数据的无锁环形队列
 // =====================================================================
-auto benchmark_throughput(int total_msgs, int p_count, int c_count) -> Coroutine<>
+template <typename T> auto benchmark_throughput(int total_msgs, int p_count, int c_count) -> Coroutine<>
 {
-    auto ch = Channel<void, 1024>(0); // 有缓冲 channel
+    using Chan = Channel<T, 1024>; // 有缓冲 channel
+    auto ch = Chan();
 
     auto start = high_resolution_clock::now();
     auto c_num = total_msgs / c_count;
@@ -113,7 +116,7 @@ auto benchmark_throughput(int total_msgs, int p_count, int c_count) -> Coroutine
     for (int i = 0; i < c_count; ++i)
     {
         wg.add(1);
-        co_spawn([](Channel<void, 1024>& ch, int num, WaitGroup& wg) -> Coroutine<> {
+        co_spawn([](Chan& ch, int num, WaitGroup& wg) -> Coroutine<> {
             for (int j = 0; j < num; ++j)
             {
                 auto v = co_await ch.recv();
@@ -127,10 +130,17 @@ auto benchmark_throughput(int total_msgs, int p_count, int c_count) -> Coroutine
     for (int i = 0; i < p_count; ++i)
     {
         wg.add(1);
-        co_spawn([](Channel<void, 1024>& ch, int p_num, WaitGroup& wg) -> Coroutine<> {
+        co_spawn([](Chan& ch, int p_num, WaitGroup& wg) -> Coroutine<> {
             for (int j = 0; j < p_num; ++j)
             {
-                co_await ch.send(); // 同理，如果 send 需参，传入伪数据
+                if constexpr (std::is_void_v<T>)
+                {
+                    co_await ch.send();
+                }
+                else
+                {
+                    co_await ch.send(1);
+                }
             }
             wg.done();
         }(ch, p_num, wg));
@@ -142,13 +152,101 @@ auto benchmark_throughput(int total_msgs, int p_count, int c_count) -> Coroutine
     double time_sec = std::chrono::duration<double>(end - start).count();
     double msgs_per_sec = total_msgs / (time_sec == 0 ? 1.0 : time_sec);
 
-    std::cout << "[3] MPMC Throughput Benchmark\n";
+    std::cout << "[3] MPMC Throughput Benchmark (" << (std::is_void_v<T> ? "Channel<void>" : "Channel<int>") << ")\n";
     std::cout << "    Producers : " << p_count << "\n";
     std::cout << "    Consumers : " << c_count << "\n";
     std::cout << "    Total Msgs: " << total_msgs << "\n";
     std::cout << "    Throughput: " << std::fixed << std::setprecision(0) << msgs_per_sec << " msgs/sec\n\n";
 }
 
+// 每次收发 batch 个，比较与逐个收发的加锁次数差异
+auto benchmark_batch_throughput(int total_msgs, int p_count, int c_count, size_t batch) -> Coroutine<>
+{
+    using Chan = Channel<int, 1024>;
+    auto ch = Chan();
+
+    auto start = high_resolution_clock::now();
+    WaitGroup producers;
+    WaitGroup consumers;
+
+    for (int i = 0; i < c_count; ++i)
+    {
+        consumers.add(1);
+        co_spawn([](Chan& ch, size_t batch, WaitGroup& wg) -> Coroutine<> {
+            std::vector<int> buffer(batch);
+            while (auto count = co_await ch.recv_many(buffer))
+            {
+                do_not_optimize(count);
+            }
+            wg.done();
+        }(ch, batch, consumers));
+    }
+
+    for (int i = 0; i < p_count; ++i)
+    {
+        producers.add(1);
+        co_spawn([](Chan& ch, int p_num, size_t batch, WaitGroup& wg) -> Coroutine<> {
+            std::vector<int> values(batch, 1);
+            for (int j = 0; j < p_num; j += static_cast<int>(batch))
+            {
+                co_await ch.send_many(values);
+            }
+            wg.done();
+        }(ch, total_msgs / p_count, batch, producers));
+    }
+
+    co_await producers.wait();
+    ch.close();
+    co_await consumers.wait();
+    auto end = high_resolution_clock::now();
+
+    double time_sec = std::chrono::duration<double>(end - start).count();
+    double msgs_per_sec = total_msgs / (time_sec == 0 ? 1.0 : time_sec);
+
+    std::cout << "[4] MPMC Batch Throughput Benchmark (Channel<int>, batch " << batch << ")\n";
+    std::cout << "    Producers : " << p_count << "\n";
+    std::cout << "    Consumers : " << c_count << "\n";
+    std::cout << "    Total Msgs: " << total_msgs << "\n";
+    std::cout << "    Throughput: " << std::fixed << std::setprecision(0) << msgs_per_sec << " msgs/sec\n\n";
+}
+
+// 一个生产者一个消费者，比较 MPMC 与 SPSC 模式
+template <ChannelMode Mode> auto benchmark_pipe(int total_msgs) -> Coroutine<>
+{
+    using Chan = Channel<int, 1024, Mode>;
+    auto ch = Chan();
+
+    auto start = high_resolution_clock::now();
+    WaitGroup wg;
+    wg.add(2);
+    co_spawn([](Chan& ch, int num, WaitGroup& wg) -> Coroutine<> {
+        for (int j = 0; j < num; ++j)
+        {
+            auto v = co_await ch.recv();
+            do_not_optimize(v);
+        }
+        wg.done();
+    }(ch, total_msgs, wg));
+    co_spawn([](Chan& ch, int num, WaitGroup& wg) -> Coroutine<> {
+        for (int j = 0; j < num; ++j)
+        {
+            co_await ch.send(1);
+        }
+        wg.done();
+    }(ch, total_msgs, wg));
+
+    co_await wg.wait();
+    auto end = high_resolution_clock::now();
+
+    double time_sec = std::chrono::duration<double>(end - start).count();
+    double msgs_per_sec = total_msgs / (time_sec == 0 ? 1.0 : time_sec);
+
+    std::cout << "[5] Pipe Throughput Benchmark (Channel<int>, " << (Mode == ChannelMode::SPSC ? "SPSC" : "MPMC")
+              << ")\n";
+    std::cout << "    Total Msgs: " << total_msgs << "\n";
+    std::cout << "    Throughput: " << std::fixed << std::setprecision(0) << msgs_per_sec << " msgs/sec\n\n";
+}
+
 auto main_coro() -> utils::MainCoroutine
 {
     std::cout << "=== C++ Stackless Coroutine Benchmark Suite ===\n\n";
@@ -162,7 +260,13 @@ auto main_coro() -> utils::MainCoroutine
     // 3. 测试吞吐 (16 生产者, 16 消费者)
     // 注意：如果是单线程调度器，测试结果仅代表无锁情况下的吞吐；
     // 如果支持多线程 Work-Stealing 调度，则会对标 Go 的 GOMAXPROCS>1 场景。
-    co_await benchmark_throughput(10000000, 16, 16);
+    co_await benchmark_throughput<void>(10000000, 16, 16);
+    // 与 Go channel_bench.go 的 chan int 对应
+    co_await benchmark_throughput<int>(10000000, 16, 16);
+    co_await benchmark_batch_throughput(10000000, 16, 16, 64);
+    // 4. 单生产者单消费者
+    co_await benchmark_pipe<ChannelMode::MPMC>(10000000);
+    co_await benchmark_pipe<ChannelMode::SPSC>(10000000);
     std::cout << "new count: " << new_count.load() << ", delete count: " << delete_count.load() << "\n";
     co_return 0; // 或者不返回，取决于 Coroutine<int> 的实现
 }
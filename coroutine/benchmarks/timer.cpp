@@ -0,0 +1,97 @@
+// 时间轮压测：100 万个定时器下 poll(get_next_timeout) 与 update 的开销
+#include "timewheel.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <random>
+
+using namespace std::chrono;
+
+// 防止编译器优化掉读取结果
+template <class T> void do_not_optimize(T&& val) { asm volatile("" : : "g"(val) : "memory"); }
+
+uint64_t now_ms() { return duration_cast<MS>(Clock::now().time_since_epoch()).count(); }
+
+// =====================================================================
+// --- 实验 1: 阻塞 poll 前计算下一次超时 ---
+// =====================================================================
+void benchmark_next_timeout(BitwiseTimerWheel& wheel, int iterations)
+{
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        do_not_optimize(wheel.get_next_timeout());
+    }
+    auto end = high_resolution_clock::now();
+    auto total_ns = duration_cast<nanoseconds>(end - start).count();
+
+    std::cout << "[1] get_next_timeout Benchmark\n";
+    std::cout << "    Iterations     : " << iterations << "\n";
+    std::cout << "    Next timeout   : " << wheel.get_next_timeout() << " ms\n";
+    std::cout << "    Time per call  : " << total_ns / iterations << " ns\n\n";
+}
+
+// =====================================================================
+// --- 实验 2: P 长时间阻塞后一次性推进时间轮 ---
+// =====================================================================
+void benchmark_idle_update(BitwiseTimerWheel& wheel, uint64_t base, uint64_t idle_ms, int rounds)
+{
+    size_t fired = 0;
+    auto start = high_resolution_clock::now();
+    for (int i = 1; i <= rounds; ++i)
+    {
+        fired += wheel.update(base + i * idle_ms).size();
+    }
+    auto end = high_resolution_clock::now();
+    auto total_ns = duration_cast<nanoseconds>(end - start).count();
+
+    std::cout << "[2] Idle update Benchmark\n";
+    std::cout << "    Idle per update: " << idle_ms << " ms\n";
+    std::cout << "    Rounds         : " << rounds << "\n";
+    std::cout << "    Timers fired   : " << fired << "\n";
+    std::cout << "    Time per update: " << total_ns / rounds << " ns\n\n";
+}
+
+// =====================================================================
+// --- 实验 3: 逐毫秒推进（常态下每次 poll 后的 update）---
+// =====================================================================
+void benchmark_tick_update(BitwiseTimerWheel& wheel, uint64_t base, int ticks)
+{
+    size_t fired = 0;
+    auto start = high_resolution_clock::now();
+    for (int i = 1; i <= ticks; ++i)
+    {
+        fired += wheel.update(base + i).size();
+    }
+    auto end = high_resolution_clock::now();
+    auto total_ns = duration_cast<nanoseconds>(end - start).count();
+
+    std::cout << "[3] Per-tick update Benchmark\n";
+    std::cout << "    Ticks          : " << ticks << "\n";
+    std::cout << "    Timers fired   : " << fired << "\n";
+    std::cout << "    Time per update: " << total_ns / ticks << " ns\n\n";
+}
+
+int main()
+{
+    std::cout << "=== Timer Wheel Benchmark Suite ===\n\n";
+
+    constexpr size_t timer_count = 1000000;
+    BitwiseTimerWheel wheel{MS(1), std::vector<size_t>{8, 6, 6, 6, 6}};
+    std::mt19937_64 rng(42);
+    // 1 分钟到 1 小时之间的长超时，模拟大量空闲连接的超时定时器
+    std::uniform_int_distribution<uint64_t> dist(60 * 1000, 3600 * 1000);
+    for (size_t i = 0; i < timer_count; ++i)
+    {
+        wheel.add_timer(MS(dist(rng)), reinterpret_cast<void*>(i + 1));
+    }
+    std::cout << "Armed timers: " << timer_count << "\n\n";
+
+    auto base = now_ms();
+    benchmark_next_timeout(wheel, 1000000);
+    // 模拟阻塞 10 秒后唤醒
+    benchmark_idle_update(wheel, base, 10 * 1000, 100);
+    benchmark_tick_update(wheel, base + 100 * 10 * 1000, 100000);
+    return 0;
+}
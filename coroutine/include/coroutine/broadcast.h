@@ -0,0 +1,388 @@
+#pragma once
+
+#include "coroutine/channel.h"
+#include "coroutine/coroutine.h"
+#include "coroutine/cospawn.h"
+#include "coroutine/intrusivelist.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <tuple>
+#include <utility>
+
+namespace utils
+{
+
+// 订阅者落后一整圈时的处理方式
+enum class LagPolicy
+{
+    // 覆盖最旧的数据，落后的订阅者跳到仍保留的最旧一条，跳过的条数计入 lagged()
+    DropOldest,
+    // 发送者挂起，直到最慢的订阅者读走最旧的一条
+    Block
+};
+
+/**
+ * @brief 广播 channel：每条数据只写入一次，所有订阅者都能收到
+ * 数据以 shared_ptr<const T> 存在环形槽位里，订阅者各自持有读位置，收到的是同一份数据，不拷贝
+ * 每个槽位记录还有几个订阅者没读，都读完（或退订）后立即释放数据；Block 策略下发送者据此判断能否覆盖
+ * 订阅者只能看到订阅之后发送的数据，没有订阅者时发送的数据直接丢弃
+ * 收发都在一把锁内完成，有订阅者挂起时发送方直接把数据交给它们
+ * @tparam Capacity 每个订阅者最多落后的条数
+ */
+template <typename T, size_t Capacity, LagPolicy Policy = LagPolicy::DropOldest> class BroadcastChannel
+{
+    static_assert(Capacity > 0, "广播 channel 的容量至少为 1");
+
+  public:
+    using Payload = std::shared_ptr<const T>;
+    class Subscriber;
+
+    class SendAwaiter : public ChannelWaiter
+    {
+      public:
+        SendAwaiter(BroadcastChannel* channel, Payload&& payload) : channel_(channel), payload_(std::move(payload)) {}
+        bool await_ready() const noexcept { return false; }
+        template <typename Promise> bool await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            promise_ = &handle.promise();
+            return channel_->send_impl(this);
+        }
+        // CLOSED 表示 channel 已关闭，数据没有发出
+        auto await_resume() const { return state_; }
+
+      private:
+        auto set_value(State state)
+        {
+            state_ = state;
+            return complete();
+        }
+
+        BroadcastChannel* channel_;
+        Payload payload_;
+        State state_{State::CLOSED};
+        friend class BroadcastChannel;
+    };
+
+    class RecvAwaiter : public ChannelWaiter
+    {
+      public:
+        RecvAwaiter(Subscriber* subscriber) : subscriber_(subscriber) {}
+        bool await_ready() const noexcept { return false; }
+        template <typename Promise> bool await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            promise_ = &handle.promise();
+            return subscriber_->channel_->recv_impl(this);
+        }
+        // channel 关闭且已读完时返回 {nullptr, CLOSED}
+        auto await_resume() { return std::tuple<Payload, State>{std::move(payload_), state_}; }
+
+      private:
+        auto set_value(Payload payload, State state)
+        {
+            payload_ = std::move(payload);
+            state_ = state;
+            return complete();
+        }
+
+        Subscriber* subscriber_;
+        Payload payload_;
+        State state_{State::CLOSED};
+        friend class BroadcastChannel;
+    };
+
+    // 订阅句柄，析构时退订；同一时刻只能有一个协程在它上面接收，不能比 channel 活得久
+    class Subscriber
+    {
+      public:
+        Subscriber(Subscriber&& other) noexcept
+            : channel_(std::exchange(other.channel_, nullptr)), cursor_(other.cursor_), lagged_(other.lagged_)
+        {
+        }
+        Subscriber& operator=(Subscriber&& other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                channel_ = std::exchange(other.channel_, nullptr);
+                cursor_ = other.cursor_;
+                lagged_ = other.lagged_;
+            }
+            return *this;
+        }
+        ~Subscriber() { reset(); }
+
+        auto recv() { return RecvAwaiter{this}; }
+        // 不挂起：有未读的数据时取出一条，否则返回空
+        auto try_recv() -> std::optional<Payload>
+        {
+            IntrusiveDList ready;
+            std::optional<Payload> payload;
+            {
+                std::lock_guard lock(channel_->mutex_);
+                payload = channel_->take_locked(this, ready);
+            }
+            ChannelWaiter::resume_all(ready);
+            return payload;
+        }
+        // DropOldest 策略下因为落后被覆盖而跳过的总条数，只在接收的协程里读取
+        uint64_t lagged() const { return lagged_; }
+        // 退订，之后不能再接收
+        void reset()
+        {
+            if (channel_)
+            {
+                std::exchange(channel_, nullptr)->unsubscribe(this);
+            }
+        }
+
+      private:
+        Subscriber(BroadcastChannel* channel, uint64_t cursor) : channel_(channel), cursor_(cursor) {}
+
+        BroadcastChannel* channel_;
+        // 下一条要读的序号，持有 channel 的锁时访问
+        uint64_t cursor_;
+        uint64_t lagged_{0};
+        friend class BroadcastChannel;
+    };
+
+    BroadcastChannel() = default;
+    BroadcastChannel(const BroadcastChannel&) = delete;
+    BroadcastChannel& operator=(const BroadcastChannel&) = delete;
+    ~BroadcastChannel() { close(); }
+
+    auto subscribe() -> Subscriber
+    {
+        std::lock_guard lock(mutex_);
+        ++subscribers_;
+        return Subscriber{this, tail_};
+    }
+    auto send(T value) { return send(std::make_shared<const T>(std::move(value))); }
+    // 已经在 shared_ptr 中的数据直接共享，不拷贝
+    auto send(Payload payload) { return SendAwaiter{this, std::move(payload)}; }
+    // 不挂起：Block 策略下最慢的订阅者还没读走最旧的一条时返回 false，已关闭时也返回 false
+    bool try_send(Payload payload);
+    // 唤醒所有挂起的收发方；订阅者仍然可以读完关闭前发送的数据
+    void close();
+    size_t subscriber_count() const
+    {
+        std::lock_guard lock(mutex_);
+        return subscribers_;
+    }
+
+  private:
+    struct Slot
+    {
+        Payload payload;
+        // 还没读这一条的订阅者数，为 0 时 payload 已释放
+        size_t remaining{0};
+    };
+
+    bool send_impl(SendAwaiter* awaiter);
+    bool recv_impl(RecvAwaiter* awaiter);
+    void unsubscribe(Subscriber* subscriber);
+
+    // 以下都要持有 mutex_，需要恢复的协程放进 ready，出锁后恢复
+    // Block 策略下下一个槽位还有订阅者没读时不能写
+    bool writable_locked() const
+    {
+        return Policy == LagPolicy::DropOldest || slots_[tail_ % Capacity].remaining == 0;
+    }
+    // 写入一条：挂起的订阅者直接拿走，其余的留在槽位里
+    void publish_locked(Payload&& payload, IntrusiveDList& ready);
+    // 取出 subscriber 的下一条，没有时返回空
+    auto take_locked(Subscriber* subscriber, IntrusiveDList& ready) -> std::optional<Payload>;
+    // 读走或退订释放了槽位，把挂起的发送者按顺序写进去
+    void refill_locked(IntrusiveDList& ready);
+    // 槽位的一个订阅者不再需要它
+    void release_locked(Slot& slot)
+    {
+        if (--slot.remaining == 0)
+        {
+            slot.payload.reset();
+        }
+    }
+    // 仍保留在槽位中的最旧序号
+    uint64_t oldest_locked() const { return tail_ > Capacity ? tail_ - Capacity : 0; }
+
+    mutable std::mutex mutex_;
+    std::array<Slot, Capacity> slots_{};
+    // 下一条要写的序号
+    uint64_t tail_{0};
+    size_t subscribers_{0};
+    bool closed_{false};
+    WaitQueue<SendAwaiter> senders_;
+    // 挂起的订阅者都已读到 tail_
+    WaitQueue<RecvAwaiter> receivers_;
+};
+
+template <typename T, size_t Capacity, LagPolicy Policy>
+void BroadcastChannel<T, Capacity, Policy>::publish_locked(Payload&& payload, IntrusiveDList& ready)
+{
+    size_t delivered = 0;
+    while (auto recv_awaiter = receivers_.take())
+    {
+        recv_awaiter->subscriber_->cursor_ = tail_ + 1;
+        recv_awaiter->set_value(payload, State::OK);
+        ready.push_back(recv_awaiter);
+        ++delivered;
+    }
+    // DropOldest 时直接覆盖，落后的订阅者在读取时发现并跳过
+    auto& slot = slots_[tail_ % Capacity];
+    slot.remaining = subscribers_ - delivered;
+    slot.payload = slot.remaining > 0 ? std::move(payload) : nullptr;
+    ++tail_;
+}
+
+template <typename T, size_t Capacity, LagPolicy Policy>
+auto BroadcastChannel<T, Capacity, Policy>::take_locked(Subscriber* subscriber, IntrusiveDList& ready)
+    -> std::optional<Payload>
+{
+    if constexpr (Policy == LagPolicy::DropOldest)
+    {
+        auto oldest = oldest_locked();
+        if (subscriber->cursor_ < oldest)
+        {
+            subscriber->lagged_ += oldest - subscriber->cursor_;
+            subscriber->cursor_ = oldest;
+        }
+    }
+    if (subscriber->cursor_ == tail_)
+    {
+        return std::nullopt;
+    }
+    auto& slot = slots_[subscriber->cursor_++ % Capacity];
+    // 最后一个读的订阅者直接拿走，不增加引用计数
+    Payload payload = slot.remaining == 1 ? std::move(slot.payload) : slot.payload;
+    release_locked(slot);
+    if constexpr (Policy == LagPolicy::Block)
+    {
+        refill_locked(ready);
+    }
+    return payload;
+}
+
+template <typename T, size_t Capacity, LagPolicy Policy>
+void BroadcastChannel<T, Capacity, Policy>::refill_locked(IntrusiveDList& ready)
+{
+    while (!senders_.empty() && writable_locked())
+    {
+        auto send_awaiter = senders_.pop();
+        publish_locked(std::move(send_awaiter->payload_), ready);
+        send_awaiter->set_value(State::OK);
+        ready.push_back(send_awaiter);
+    }
+}
+
+template <typename T, size_t Capacity, LagPolicy Policy>
+bool BroadcastChannel<T, Capacity, Policy>::send_impl(SendAwaiter* send_awaiter)
+{
+    IntrusiveDList ready;
+    {
+        std::lock_guard lock(mutex_);
+        if (closed_)
+        {
+            return false;
+        }
+        // 已有发送者挂起时不插队
+        if (!senders_.empty() || !writable_locked())
+        {
+            senders_.push(send_awaiter);
+            return true;
+        }
+        publish_locked(std::move(send_awaiter->payload_), ready);
+        send_awaiter->set_value(State::OK);
+    }
+    ChannelWaiter::resume_all(ready);
+    return false;
+}
+
+template <typename T, size_t Capacity, LagPolicy Policy>
+bool BroadcastChannel<T, Capacity, Policy>::recv_impl(RecvAwaiter* recv_awaiter)
+{
+    IntrusiveDList ready;
+    {
+        std::lock_guard lock(mutex_);
+        auto payload = take_locked(recv_awaiter->subscriber_, ready);
+        if (payload)
+        {
+            recv_awaiter->set_value(std::move(*payload), State::OK);
+        }
+        else if (!closed_)
+        {
+            receivers_.push(recv_awaiter);
+            return true;
+        }
+    }
+    // 挂起后本协程可能已被其他线程恢复，之后只能访问局部变量
+    ChannelWaiter::resume_all(ready);
+    return false;
+}
+
+template <typename T, size_t Capacity, LagPolicy Policy>
+bool BroadcastChannel<T, Capacity, Policy>::try_send(Payload payload)
+{
+    IntrusiveDList ready;
+    {
+        std::lock_guard lock(mutex_);
+        if (closed_ || !senders_.empty() || !writable_locked())
+        {
+            return false;
+        }
+        publish_locked(std::move(payload), ready);
+    }
+    ChannelWaiter::resume_all(ready);
+    return true;
+}
+
+template <typename T, size_t Capacity, LagPolicy Policy> void BroadcastChannel<T, Capacity, Policy>::close()
+{
+    IntrusiveDList ready;
+    {
+        std::lock_guard lock(mutex_);
+        if (closed_)
+        {
+            return;
+        }
+        closed_ = true;
+        while (auto send_awaiter = senders_.take())
+        {
+            send_awaiter->set_value(State::CLOSED);
+            ready.push_back(send_awaiter);
+        }
+        while (auto recv_awaiter = receivers_.take())
+        {
+            recv_awaiter->set_value(nullptr, State::CLOSED);
+            ready.push_back(recv_awaiter);
+        }
+    }
+    ChannelWaiter::resume_all(ready);
+}
+
+template <typename T, size_t Capacity, LagPolicy Policy>
+void BroadcastChannel<T, Capacity, Policy>::unsubscribe(Subscriber* subscriber)
+{
+    IntrusiveDList ready;
+    {
+        std::lock_guard lock(mutex_);
+        // 还没读的槽位少一个读者
+        for (auto seq = std::max(subscriber->cursor_, oldest_locked()); seq < tail_; ++seq)
+        {
+            release_locked(slots_[seq % Capacity]);
+        }
+        --subscribers_;
+        if constexpr (Policy == LagPolicy::Block)
+        {
+            refill_locked(ready);
+        }
+    }
+    ChannelWaiter::resume_all(ready);
+}
+
+} // namespace utils
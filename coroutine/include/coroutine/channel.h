@@ -3,14 +3,18 @@
 #include "coroutine/coroutine.h"
 #include "coroutine/cospawn.h"
 #include "coroutine/intrusivelist.h"
-#include "coroutine/ringbuffer.h"
+#include "coroutine/mpmcring.h"
 #include "coroutine/spinlock.h"
+#include <atomic>
 #include <cassert>
 #include <coroutine>
 #include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <mutex>
+#include <optional>
 #include <queue>
+#include <span>
 #include <tuple>
 #include <type_traits>
 #include <variant>
@@ -23,14 +27,199 @@ enum class State
     CLOSED
 };
 
-template <typename T, size_t Capacity> class Channel;
+// 收发双方的数量：SPSC 只允许一个发送协程和一个接收协程，换来不加锁的收发
+enum class ChannelMode
+{
+    MPMC,
+    SPSC
+};
+
+template <typename T, size_t Capacity, ChannelMode Mode = ChannelMode::MPMC> class Channel;
+template <typename T, size_t Capacity> class RecvCase;
+template <typename T, size_t Capacity> class SendCase;
+template <typename Node> class WaitQueue;
+
+// select 的完成状态：各分支的等待节点挂在不同 channel 上，只有一个分支能完成
+// -1 表示还在等待，>= 0 为完成的分支，<= -2 表示某个 channel 正持锁暂时占用（见 try_claim）
+class Selector
+{
+  public:
+    // 持有分支所在 channel 的锁时调用，成功后必须 commit 或 abort
+    // 已由其他分支完成时返回 false；另一个 channel 暂时占用时自旋，对方只在自己的临界区内占用，且不会再等待别人
+    bool try_claim(int index) noexcept
+    {
+        while (true)
+        {
+            int expected = Waiting;
+            if (state_.compare_exchange_weak(expected, claiming(index), std::memory_order_acquire,
+                                             std::memory_order_relaxed))
+            {
+                return true;
+            }
+            if (expected >= 0)
+            {
+                return false;
+            }
+            _mm_pause();
+        }
+    }
+    void commit() noexcept
+    {
+        state_.store(-2 - state_.load(std::memory_order_relaxed), std::memory_order_release);
+    }
+    void abort() noexcept { state_.store(Waiting, std::memory_order_release); }
+    // select 持有所有分支的锁时直接定出结果
+    void set_winner(int index) noexcept { state_.store(index, std::memory_order_release); }
+    // 还没有分支完成时返回 -1
+    int winner() const noexcept
+    {
+        auto state = state_.load(std::memory_order_acquire);
+        return state >= 0 ? state : -1;
+    }
+
+  private:
+    constexpr static int Waiting = -1;
+    constexpr static int claiming(int index) noexcept { return -2 - index; }
+    std::atomic<int> state_{Waiting};
+};
+
+// channel 等待节点的公共部分，selector_ 非空时节点是 select 的一个分支
+class ChannelWaiter : public IntrusiveListDNode
+{
+  public:
+    ChannelWaiter() = default;
+    // select 的分支在登记之前按值传递，只允许移动还没有入队的节点
+    ChannelWaiter(ChannelWaiter&& other) noexcept : IntrusiveListDNode() { assert(!other.queued_); }
+
+    // 恢复 ready 中已完成的等待者，调用方不能持有 channel 的锁
+    static void resume_all(IntrusiveDList& ready)
+    {
+        while (!ready.empty())
+        {
+            co_spawn(static_cast<ChannelWaiter*>(ready.pop_front())->promise_);
+        }
+    }
+
+  protected:
+    // 普通等待者总能占住；select 分支已由其他分支完成时返回 false
+    bool claim() noexcept { return selector_ == nullptr || selector_->try_claim(case_index_); }
+    void abort_claim() noexcept
+    {
+        if (selector_)
+        {
+            selector_->abort();
+        }
+    }
+    // 写入结果之后调用，返回需要恢复的协程
+    Promise* complete() noexcept
+    {
+        if (selector_)
+        {
+            selector_->commit();
+        }
+        return promise_;
+    }
+
+    Promise* promise_{};
+    Selector* selector_{};
+    int case_index_{-1};
+    // 是否在等待队列中，持有 channel 的锁时访问
+    bool queued_{false};
+
+    template <typename Node> friend class WaitQueue;
+};
+
+// channel 一侧的等待队列，除 waiting() 外都要持有 channel 的锁
+template <typename Node> class WaitQueue
+{
+  public:
+    // 挂起的节点数，快路径不加锁读取
+    size_t waiting() const noexcept { return waiting_.load(std::memory_order_relaxed); }
+    bool empty() const noexcept { return list_.empty(); }
+    Node* front() const noexcept { return static_cast<Node*>(list_.front()); }
+    Node* back() const noexcept { return static_cast<Node*>(list_.back()); }
+
+    void push(Node* node) noexcept
+    {
+        list_.push_back(node);
+        node->queued_ = true;
+        waiting_.fetch_add(1, std::memory_order_relaxed);
+    }
+    Node* pop() noexcept
+    {
+        auto node = static_cast<Node*>(list_.pop_front());
+        node->queued_ = false;
+        waiting_.fetch_sub(1, std::memory_order_relaxed);
+        return node;
+    }
+    // 不在队列中时什么也不做
+    void remove(Node* node) noexcept
+    {
+        if (!node->queued_)
+        {
+            return;
+        }
+        // 只有一个节点时 IntrusiveDList::remove 认不出它已链入，首尾单独处理
+        if (node == front())
+        {
+            list_.pop_front();
+        }
+        else if (node == back())
+        {
+            list_.pop_back();
+        }
+        else
+        {
+            list_.remove(node);
+        }
+        node->queued_ = false;
+        waiting_.fetch_sub(1, std::memory_order_relaxed);
+    }
+    // 占住队首第一个还能完成的节点，select 中已经由其他分支完成的直接丢弃
+    // 占住后要么 pop 出来完成它，要么 abort_claim 放回
+    Node* claim_front() noexcept
+    {
+        while (!list_.empty())
+        {
+            auto node = front();
+            if (node->claim())
+            {
+                return node;
+            }
+            pop();
+        }
+        return nullptr;
+    }
+    // 取出队首第一个还能完成的节点
+    Node* take() noexcept
+    {
+        auto node = claim_front();
+        if (node)
+        {
+            pop();
+        }
+        return node;
+    }
+
+  private:
+    IntrusiveDList list_;
+    std::atomic<size_t> waiting_{0};
+};
 
-template <typename T, size_t Capacity> class Channel
+// 有缓冲时，缓冲区既不满也不空、且没有协程挂起的收发只操作无锁环形队列，不加锁
+// 需要挂起或唤醒等待者时才进入加锁的慢路径：
+// 挂起方先登记等待计数再重新检查队列，快路径成功后再检查等待计数，两边各有一个 seq_cst 栅栏，
+// 保证要么挂起方重新检查时看到数据/空位，要么快路径看到等待者并负责唤醒
+// Capacity 为 DynamicCapacity 时容量由构造函数指定，队列换成按需增长的 DynamicRing
+template <typename T, size_t Capacity> class Channel<T, Capacity, ChannelMode::MPMC>
 {
+    constexpr static bool Buffered = Capacity > 0;
+    constexpr static bool Dynamic = Capacity == DynamicCapacity;
+
   public:
     using Lock = std::mutex;
 
-    class SendAwaiter : public IntrusiveListDNode
+    class SendAwaiter : public ChannelWaiter
     {
       public:
         SendAwaiter(Channel<T, Capacity>* channel, T&& value) : channel_(channel), value_(std::move(value)) {}
@@ -47,18 +236,19 @@ template <typename T, size_t Capacity> class Channel
         auto set_value(State state)
         {
             state_ = state;
-            return promise_;
+            return complete();
         }
 
       private:
         Channel<T, Capacity>* channel_;
         T value_{};
         State state_{State::CLOSED};
-        Promise* promise_{};
+        friend class Channel;
+        friend class SendCase<T, Capacity>;
     };
 
     // 接收操作
-    class RecvAwaiter : public IntrusiveListDNode
+    class RecvAwaiter : public ChannelWaiter
     {
 
       public:
@@ -85,7 +275,7 @@ template <typename T, size_t Capacity> class Channel
         {
             value_ = std::move(value);
             state_ = state;
-            return promise_;
+            return complete();
         }
         void cancel() {}
 
@@ -93,14 +283,68 @@ template <typename T, size_t Capacity> class Channel
         Channel<T, Capacity>* channel_;
         T value_{};
         State state_ = State::CLOSED;
-        Promise* promise_;
+        friend class Channel;
+        friend class RecvCase<T, Capacity>;
+        friend class RecvManyAwaiter;
     };
-    Channel() = default;
+
+    // 批量接收：先不挂起地取走能取的，一个都没有时按 recv 挂起，恢复后再顺带取走后面已经就绪的
+    class RecvManyAwaiter
+    {
+      public:
+        RecvManyAwaiter(Channel<T, Capacity>* channel, std::span<T> out) : first_(channel), out_(out)
+        {
+            assert(!out.empty());
+        }
+        bool await_ready() noexcept
+        {
+            count_ = first_.channel_->drain(out_);
+            return count_ > 0;
+        }
+        template <typename Promise> bool await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            return first_.await_suspend(handle);
+        }
+        // 返回取到的个数，0 表示 channel 已关闭且为空
+        size_t await_resume()
+        {
+            if (count_ > 0 || first_.state_ != State::OK)
+            {
+                return count_;
+            }
+            out_[0] = std::move(first_.value_);
+            return 1 + first_.channel_->drain(out_.subspan(1));
+        }
+
+      private:
+        RecvAwaiter first_;
+        std::span<T> out_;
+        size_t count_{0};
+    };
+
+    Channel()
+        requires(!Dynamic)
+    = default;
+    // Capacity 为 DynamicCapacity 时在运行时指定容量，存储随排队的数据增长、空闲后收缩，0 为无缓冲
+    explicit Channel(size_t capacity)
+        requires(Dynamic)
+        : ring_(capacity)
+    {
+    }
     ~Channel() { close(); }
 
     auto recv() { return RecvAwaiter{this}; }
+    // 不挂起：有数据时取出一个，否则返回空
+    auto try_recv() -> std::optional<T>;
+    // 等到至少有一个数据或 channel 关闭，一次取出最多 out.size() 个，返回个数，0 表示已关闭且为空
+    auto recv_many(std::span<T> out) { return RecvManyAwaiter{this, out}; }
 
     auto send(T value) { return SendAwaiter{this, std::move(value)}; }
+    // 不挂起：有接收者在等或队列未满时发送并返回 true，失败（已满或已关闭）时 value 保持不变
+    bool try_send(T&& value) { return fill(std::span<T>(&value, 1)) == 1; }
+    // 按顺序发送全部数据，队列满时挂起，能放下的部分一次加锁批量写入并唤醒接收者
+    // 返回发送的个数，少于 values.size() 说明 channel 已关闭
+    auto send_many(std::span<T> values) -> Coroutine<size_t>;
     auto send()
         requires(std::is_same_v<T, std::monostate>)
     {
@@ -108,290 +352,1249 @@ template <typename T, size_t Capacity> class Channel
     }
     void close()
     {
+        IntrusiveDList ready;
         {
             auto guard = std::lock_guard(mutex_);
-            if (is_closed_)
+            if (is_closed_.load(std::memory_order_relaxed))
             {
                 return;
             }
-            is_closed_ = true;
-        }
-        while (!send_awaiters_.empty())
-        {
-            auto awaiter = send_awaiters_.pop_front();
-            auto p = static_cast<SendAwaiter*>(awaiter)->set_value(State::CLOSED);
-            co_spawn(p);
-        }
-        while (!recv_awaiters_.empty())
-        {
-            auto awaiter = recv_awaiters_.pop_front();
-            auto p = static_cast<RecvAwaiter*>(awaiter)->set_value({}, State::CLOSED);
-            co_spawn(p);
+            is_closed_.store(true, std::memory_order_release);
+            while (auto send_awaiter = senders_.take())
+            {
+                send_awaiter->set_value(State::CLOSED);
+                ready.push_back(send_awaiter);
+            }
+            while (auto recv_awaiter = receivers_.take())
+            {
+                recv_awaiter->set_value({}, State::CLOSED);
+                ready.push_back(recv_awaiter);
+            }
         }
+        ChannelWaiter::resume_all(ready);
     }
 
   private:
     bool send_impl(SendAwaiter* awaiter);
     bool recv_impl(RecvAwaiter* awaiter);
-    bool is_closed() const { return is_closed_; }
-    bool is_empty() const { return resource_.empty() && send_awaiters_.empty(); }
-    bool is_full() const { return resource_.full() && recv_awaiters_.empty(); }
+    bool is_closed() const { return is_closed_.load(std::memory_order_acquire); }
+    // 快路径写入后调用：有挂起的接收者时把队列中的数据交给它们
+    void wake_receivers();
+    // 快路径取出后调用：有挂起的发送者时把它们的数据补进队列
+    void wake_senders();
+    // 持锁调用：把能放下的挂起发送者按顺序移进队列，放进 ready 等出锁后恢复
+    void refill_locked(IntrusiveDList& ready);
+    // 持锁调用：按队列顺序把数据交给挂起的接收者，放进 ready 等出锁后恢复
+    void deliver_locked(IntrusiveDList& ready);
+    // 持锁调用：从队列取一个；取不到而有发送者挂起时先把它们补进队列再取
+    // 队首可能是快路径还没写完的槽位，挂起的发送者不能越过它直接交给接收者，否则同一发送者的数据会乱序
+    auto pop_locked(IntrusiveDList& ready) -> std::optional<T>;
+    // 不挂起地取出最多 out.size() 个数据，最多加一次锁，并一次性补进挂起的发送者
+    size_t drain(std::span<T> out);
+    // 不挂起地发送 values 的前缀，最多加一次锁，返回发送的个数
+    size_t fill(std::span<T> values);
+
+    // 以下供 select 使用，调用方持有 mutex_
+    // 能立即完成时写入结果并返回 true，notify 为需要恢复的对端，ready 为补进队列的发送者
+    bool poll_locked(RecvAwaiter* awaiter, Promise*& notify, IntrusiveDList& ready);
+    bool poll_locked(SendAwaiter* awaiter, Promise*& notify, IntrusiveDList& ready);
+    // 登记并执行 seq_cst 栅栏之后重新检查队列，与快路径的 wake_* 配对
+    bool recheck_locked(RecvAwaiter* awaiter, IntrusiveDList& ready);
+    bool recheck_locked(SendAwaiter* awaiter, IntrusiveDList& ready);
 
+    struct NoRing
+    {
+    };
+    // 无缓冲 channel 只做收发双方的直接交接，不需要队列；运行时容量的队列存储在堆上
+    using Ring = std::conditional_t<Dynamic, DynamicRing<T>,
+                                    std::conditional_t<Buffered, MpmcRing<T, Buffered && !Dynamic ? Capacity : 1>, NoRing>>;
+    [[no_unique_address]] Ring ring_{};
+    std::atomic<bool> is_closed_{false};
+
+    // 只保护两个等待队列
     Lock mutex_{};
-    RingBuffer<T, Capacity> resource_{};
+    WaitQueue<SendAwaiter> senders_;
+    WaitQueue<RecvAwaiter> receivers_;
 
-    IntrusiveDList send_awaiters_;
-    IntrusiveDList recv_awaiters_;
-    bool is_closed_ = false;
+    friend class RecvCase<T, Capacity>;
+    friend class SendCase<T, Capacity>;
 };
 
+template <typename T, size_t Capacity> void Channel<T, Capacity>::wake_receivers()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (receivers_.waiting() == 0)
+    {
+        return;
+    }
+    IntrusiveDList ready;
+    {
+        std::lock_guard lock(mutex_);
+        deliver_locked(ready);
+    }
+    ChannelWaiter::resume_all(ready);
+}
+
+template <typename T, size_t Capacity> void Channel<T, Capacity>::deliver_locked(IntrusiveDList& ready)
+{
+    while (auto recv_awaiter = receivers_.claim_front())
+    {
+        auto value = ring_.try_pop();
+        if (!value)
+        {
+            recv_awaiter->abort_claim();
+            break;
+        }
+        receivers_.pop();
+        recv_awaiter->set_value(std::move(*value), State::OK);
+        ready.push_back(recv_awaiter);
+    }
+}
+
+template <typename T, size_t Capacity> void Channel<T, Capacity>::wake_senders()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (senders_.waiting() == 0)
+    {
+        return;
+    }
+    IntrusiveDList ready;
+    {
+        std::lock_guard lock(mutex_);
+        refill_locked(ready);
+    }
+    ChannelWaiter::resume_all(ready);
+}
+
+template <typename T, size_t Capacity> void Channel<T, Capacity>::refill_locked(IntrusiveDList& ready)
+{
+    // 按挂起顺序补进队列，保持发送者之间的FIFO
+    while (auto send_awaiter = senders_.claim_front())
+    {
+        if (!ring_.try_push(send_awaiter->value_))
+        {
+            send_awaiter->abort_claim();
+            break;
+        }
+        senders_.pop();
+        send_awaiter->set_value(State::OK);
+        ready.push_back(send_awaiter);
+    }
+}
+
+template <typename T, size_t Capacity> auto Channel<T, Capacity>::pop_locked(IntrusiveDList& ready) -> std::optional<T>
+{
+    auto value = ring_.try_pop();
+    if (!value && !senders_.empty())
+    {
+        refill_locked(ready);
+        value = ring_.try_pop();
+    }
+    return value;
+}
+
 template <typename T, size_t Capacity> bool Channel<T, Capacity>::send_impl(SendAwaiter* send_awaiter)
 {
+    // channel关闭，不阻塞
+    if (is_closed())
+    {
+        return false;
+    }
+    if constexpr (Buffered)
+    {
+        // 快路径：没有协程挂起时直接写入无锁队列；已有发送者排队时不插队
+        if (receivers_.waiting() == 0 && senders_.waiting() == 0 && ring_.try_push(send_awaiter->value_))
+        {
+            send_awaiter->set_value(State::OK);
+            wake_receivers();
+            return false;
+        }
+    }
     Promise* notify = nullptr;
+    IntrusiveDList ready;
+    bool suspend = false;
     {
         std::lock_guard lock(mutex_);
-        // channel关闭，不阻塞
         if (is_closed())
         {
             return false;
         }
-        if (is_full())
+        if constexpr (Buffered)
         {
-            // channel未关闭且已满，阻塞
-            send_awaiters_.push_back(send_awaiter);
-            return true;
+            // 有缓冲时数据一律经过队列：队首可能是快路径还没写完的槽位，直接交给接收者会越过它
+            // 先登记再重新检查：快路径的接收者可能刚腾出空位却没看到等待计数
+            senders_.push(send_awaiter);
+            suspend = true;
+            // 连同排在前面的发送者一起按顺序补进队列，补进去了就不用挂起
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            refill_locked(ready);
+            if (!ready.empty() && ready.back() == send_awaiter)
+            {
+                ready.pop_back();
+                suspend = false;
+            }
+            deliver_locked(ready);
         }
-        // channel未关闭且不满，唤醒
-        // 优先给等待的接收者，防止缓冲区溢出
-        if (!recv_awaiters_.empty())
+        else if (auto recv_awaiter = receivers_.take())
         {
-            auto recv_awaiter = recv_awaiters_.pop_front();
-            notify =
-                static_cast<RecvAwaiter*>(recv_awaiter)->set_value(std::move(send_awaiter->get_value()), State::OK);
+            // 优先给等待的接收者
+            notify = recv_awaiter->set_value(send_awaiter->get_value(), State::OK);
+            send_awaiter->set_value(State::OK);
         }
         else
         {
-            resource_.push(send_awaiter->get_value());
+            senders_.push(send_awaiter);
+            suspend = true;
         }
     }
-    send_awaiter->set_value(State::OK);
+    // 挂起后本协程可能已被其他线程恢复，之后只能访问局部变量
+    ChannelWaiter::resume_all(ready);
     if (notify)
     {
         co_spawn(notify);
     }
-    return false;
+    return suspend;
 }
+
 template <typename T, size_t Capacity> bool Channel<T, Capacity>::recv_impl(RecvAwaiter* recv_awaiter)
 {
+    if constexpr (Buffered)
+    {
+        // 快路径：队列非空直接取，保持FIFO
+        if (auto value = ring_.try_pop())
+        {
+            recv_awaiter->set_value(std::move(*value), State::OK);
+            wake_senders();
+            return false;
+        }
+    }
     Promise* notify = nullptr;
+    IntrusiveDList ready;
+    // 从队列里取到了数据，出锁后把挂起的发送者补进队列
+    bool taken = false;
+    bool suspend = false;
     {
         std::lock_guard lock(mutex_);
-        // 关闭且为空，不阻塞
-        if (is_closed() && is_empty())
+        std::optional<T> value;
+        if constexpr (Buffered)
         {
-            return false;
+            value = pop_locked(ready);
         }
-        // channel未关闭且为空，阻塞
-        if (is_empty())
+        if (value)
         {
-            recv_awaiters_.push_back(recv_awaiter);
-            return true;
+            recv_awaiter->set_value(std::move(*value), State::OK);
+            taken = true;
+        }
+        else if (auto send_awaiter = Buffered ? nullptr : senders_.take())
+        {
+            // 无缓冲 channel 直接从挂起的发送者手里取
+            recv_awaiter->set_value(send_awaiter->get_value(), State::OK);
+            notify = send_awaiter->set_value(State::OK);
         }
-        // channel不空，唤醒
-        // 保持FIFO
-        if (!resource_.empty())
+        else if (!is_closed())
         {
-            recv_awaiter->set_value(std::move(resource_.front()), State::OK);
-            resource_.pop();
-            if (!send_awaiters_.empty())
+            // channel未关闭且为空，阻塞；关闭且为空时不阻塞
+            receivers_.push(recv_awaiter);
+            suspend = true;
+            if constexpr (Buffered)
             {
-                auto send_awaiter = static_cast<SendAwaiter*>(send_awaiters_.pop_front());
-                resource_.push(send_awaiter->get_value());
-                notify = send_awaiter->set_value(State::OK);
+                // 登记后重新检查：快路径的发送者可能刚写入却没看到等待计数
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                value = ring_.try_pop();
+                if (value)
+                {
+                    receivers_.remove(recv_awaiter);
+                    recv_awaiter->set_value(std::move(*value), State::OK);
+                    taken = true;
+                    suspend = false;
+                }
             }
         }
-        else
+    }
+    // 挂起后本协程可能已被其他线程恢复，之后只能访问局部变量
+    ChannelWaiter::resume_all(ready);
+    if (suspend)
+    {
+        return true;
+    }
+    if (taken)
+    {
+        if constexpr (Buffered)
         {
-            auto send_awaiter = static_cast<SendAwaiter*>(send_awaiters_.pop_front());
-            recv_awaiter->set_value(send_awaiter->get_value(), State::OK);
-            notify = send_awaiter->set_value(State::OK);
+            wake_senders();
         }
     }
-    if (notify)
+    else if (notify)
     {
         co_spawn(notify);
     }
     return false;
 }
 
-template <size_t Capacity> class Channel<void, Capacity>
+template <typename T, size_t Capacity> auto Channel<T, Capacity>::try_recv() -> std::optional<T>
 {
-  public:
-    using Lock = std::mutex;
-
-    // 以下将特化channel<void>
-    class SendAwaiter : public IntrusiveListDNode
+    if constexpr (Buffered)
     {
-      public:
-        SendAwaiter(Channel<void, Capacity>* channel) : channel_(channel) {}
-        bool await_ready() noexcept { return false; }
-        template <typename Promise> bool await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        if (auto value = ring_.try_pop())
         {
-            promise_ = &handle.promise();
-            return channel_->send_impl(this);
+            wake_senders();
+            return value;
         }
-
-        auto await_resume() const { return state_; }
-        auto set_value(State state)
+    }
+    std::optional<T> value;
+    Promise* notify = nullptr;
+    IntrusiveDList ready;
+    {
+        std::lock_guard lock(mutex_);
+        if constexpr (Buffered)
         {
-            state_ = state;
-            return promise_;
+            value = pop_locked(ready);
         }
-
-      private:
-        Channel<void, Capacity>* channel_;
-        State state_{State::CLOSED};
-        Promise* promise_{};
-    };
-
-    // 接收操作
-    class RecvAwaiter : public IntrusiveListDNode
-    {
-
-      public:
-        RecvAwaiter(Channel<void, Capacity>* channel) : channel_(channel) {}
-        auto await_ready() noexcept { return false; }
-
-        template <typename Promise> bool await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        else if (auto send_awaiter = senders_.take())
         {
-            promise_ = &handle.promise();
-            return channel_->recv_impl(this);
+            // 无缓冲 channel 直接从挂起的发送者手里取
+            value.emplace(send_awaiter->get_value());
+            notify = send_awaiter->set_value(State::OK);
         }
-
-        auto await_resume() const { return state_; }
-        auto set_value(State state)
+    }
+    ChannelWaiter::resume_all(ready);
+    if (notify)
+    {
+        co_spawn(notify);
+    }
+    else if constexpr (Buffered)
+    {
+        if (value)
         {
-            state_ = state;
-            return promise_;
+            wake_senders();
         }
+    }
+    return value;
+}
 
-      private:
-        Channel<void, Capacity>* channel_;
-        State state_ = State::CLOSED;
-        Promise* promise_;
-    };
-    Channel(size_t initial_size = 0) : size_(initial_size) { assert(initial_size <= Capacity); }
-    ~Channel() { close(); }
-    void close()
+template <typename T, size_t Capacity> size_t Channel<T, Capacity>::drain(std::span<T> out)
+{
+    size_t count = 0;
+    if constexpr (Buffered)
     {
+        while (count < out.size())
         {
-            auto guard = std::lock_guard(mutex_);
-            if (is_closed_)
+            auto value = ring_.try_pop();
+            if (!value)
             {
-                return;
+                break;
             }
-            is_closed_ = true;
+            out[count++] = std::move(*value);
         }
-        while (!send_awaiters_.empty())
+    }
+    // 与挂起发送者的 seq_cst 栅栏配对：没看到等待者时，对方重新检查会看到腾出的空位
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (senders_.waiting() == 0)
+    {
+        return count;
+    }
+    IntrusiveDList ready;
+    {
+        std::lock_guard lock(mutex_);
+        while (count < out.size())
         {
-            auto awaiter = static_cast<SendAwaiter*>(send_awaiters_.pop_front());
-            auto p = awaiter->set_value(State::CLOSED);
-            co_spawn(p);
+            std::optional<T> value;
+            if constexpr (Buffered)
+            {
+                value = pop_locked(ready);
+            }
+            if (value)
+            {
+                out[count++] = std::move(*value);
+            }
+            else if (auto send_awaiter = Buffered ? nullptr : senders_.take())
+            {
+                // 无缓冲 channel 没有队列，挂起的发送者就是下一个
+                out[count++] = send_awaiter->get_value();
+                send_awaiter->set_value(State::OK);
+                ready.push_back(send_awaiter);
+            }
+            else
+            {
+                break;
+            }
         }
-        while (!recv_awaiters_.empty())
+        if constexpr (Buffered)
         {
-            auto awaiter = static_cast<RecvAwaiter*>(recv_awaiters_.pop_front());
-            auto p = awaiter->set_value(State::CLOSED);
-            co_spawn(p);
+            refill_locked(ready);
         }
     }
-    auto recv() { return RecvAwaiter{this}; }
-
-    auto send() { return SendAwaiter{this}; }
-
-  private:
-    bool try_send(SendAwaiter* awaiter);
-    bool try_recv(RecvAwaiter* awaiter);
-    bool send_impl(SendAwaiter* awaiter);
-    bool recv_impl(RecvAwaiter* awaiter);
-    bool is_closed() const { return is_closed_; }
-    bool is_empty() const { return size_ == 0 && send_awaiters_.empty(); }
-    bool is_full() const { return size_ >= Capacity && recv_awaiters_.empty(); }
+    ChannelWaiter::resume_all(ready);
+    return count;
+}
 
-    Lock mutex_{};
-    size_t size_{};
-    IntrusiveDList send_awaiters_;
-    IntrusiveDList recv_awaiters_;
-    bool is_closed_ = false;
-};
-template <size_t Capacity> bool Channel<void, Capacity>::send_impl(SendAwaiter* send_awaiter)
+template <typename T, size_t Capacity> size_t Channel<T, Capacity>::fill(std::span<T> values)
 {
-    Promise* notify = nullptr;
+    if (is_closed())
+    {
+        return 0;
+    }
+    size_t count = 0;
+    if constexpr (Buffered)
+    {
+        // 与 send_impl 的快路径相同，已有协程挂起时走加锁的慢路径
+        if (receivers_.waiting() == 0 && senders_.waiting() == 0)
+        {
+            while (count < values.size() && ring_.try_push(values[count]))
+            {
+                ++count;
+            }
+            if (count > 0)
+            {
+                wake_receivers();
+            }
+            if (count == values.size())
+            {
+                return count;
+            }
+        }
+    }
+    IntrusiveDList ready;
     {
         std::lock_guard lock(mutex_);
-        // channel关闭，不阻塞
         if (is_closed())
         {
-            return false;
+            return count;
+        }
+        if constexpr (Buffered)
+        {
+            // 与 send_impl 相同，数据先进队列再按顺序交给接收者；不插到挂起的发送者前面
+            while (count < values.size() && senders_.empty() && ring_.try_push(values[count]))
+            {
+                ++count;
+            }
+            deliver_locked(ready);
+        }
+        else
+        {
+            while (count < values.size())
+            {
+                auto recv_awaiter = receivers_.take();
+                if (!recv_awaiter)
+                {
+                    break;
+                }
+                recv_awaiter->set_value(std::move(values[count++]), State::OK);
+                ready.push_back(recv_awaiter);
+            }
+        }
+    }
+    ChannelWaiter::resume_all(ready);
+    return count;
+}
+
+template <typename T, size_t Capacity>
+auto Channel<T, Capacity>::send_many(std::span<T> values) -> Coroutine<size_t>
+{
+    size_t sent = 0;
+    while (sent < values.size())
+    {
+        sent += fill(values.subspan(sent));
+        if (sent == values.size())
+        {
+            break;
         }
-        if (is_full())
+        // 放不下了，挂起等一个空位，恢复后继续批量写入
+        if (co_await send(std::move(values[sent])) != State::OK)
+        {
+            break;
+        }
+        ++sent;
+    }
+    co_return sent;
+}
+
+template <typename T, size_t Capacity>
+bool Channel<T, Capacity>::poll_locked(RecvAwaiter* recv_awaiter, Promise*& notify, IntrusiveDList& ready)
+{
+    std::optional<T> value;
+    if constexpr (Buffered)
+    {
+        value = pop_locked(ready);
+    }
+    if (value)
+    {
+        recv_awaiter->value_ = std::move(*value);
+        recv_awaiter->state_ = State::OK;
+        return true;
+    }
+    if (auto send_awaiter = Buffered ? nullptr : senders_.take())
+    {
+        recv_awaiter->value_ = send_awaiter->get_value();
+        recv_awaiter->state_ = State::OK;
+        notify = send_awaiter->set_value(State::OK);
+        return true;
+    }
+    if (is_closed())
+    {
+        recv_awaiter->state_ = State::CLOSED;
+        return true;
+    }
+    return false;
+}
+
+template <typename T, size_t Capacity>
+bool Channel<T, Capacity>::poll_locked(SendAwaiter* send_awaiter, Promise*& notify, IntrusiveDList& ready)
+{
+    if (is_closed())
+    {
+        send_awaiter->state_ = State::CLOSED;
+        return true;
+    }
+    if constexpr (Buffered)
+    {
+        // 与 send_impl 相同，数据先进队列再按顺序交给接收者
+        if (senders_.empty() && ring_.try_push(send_awaiter->value_))
         {
-            // channel未关闭且已满，阻塞
-            send_awaiters_.push_back(send_awaiter);
+            send_awaiter->state_ = State::OK;
+            deliver_locked(ready);
             return true;
         }
-        // channel未关闭且不满，唤醒
-        if (!recv_awaiters_.empty())
+    }
+    else if (auto recv_awaiter = receivers_.take())
+    {
+        notify = recv_awaiter->set_value(send_awaiter->get_value(), State::OK);
+        send_awaiter->state_ = State::OK;
+        return true;
+    }
+    return false;
+}
+
+template <typename T, size_t Capacity>
+bool Channel<T, Capacity>::recheck_locked(RecvAwaiter* recv_awaiter, IntrusiveDList&)
+{
+    if constexpr (Buffered)
+    {
+        if (auto value = ring_.try_pop())
+        {
+            receivers_.remove(recv_awaiter);
+            recv_awaiter->value_ = std::move(*value);
+            recv_awaiter->state_ = State::OK;
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename T, size_t Capacity>
+bool Channel<T, Capacity>::recheck_locked(SendAwaiter* send_awaiter, IntrusiveDList& ready)
+{
+    if constexpr (Buffered)
+    {
+        // 与 send_impl 相同，按顺序补进队列；同一个 select 的分支由 select 自己处理，不放进 ready
+        IntrusiveDList moved;
+        refill_locked(moved);
+        bool done = false;
+        while (!moved.empty())
+        {
+            auto waiter = static_cast<SendAwaiter*>(moved.pop_front());
+            if (waiter->selector_ && waiter->selector_ == send_awaiter->selector_)
+            {
+                done = true;
+            }
+            else
+            {
+                ready.push_back(waiter);
+            }
+        }
+        return done;
+    }
+    return false;
+}
+
+template <size_t Capacity> class Channel<void, Capacity>
+{
+  public:
+    using Lock = std::mutex;
+
+    // 以下将特化channel<void>
+    class SendAwaiter : public ChannelWaiter
+    {
+      public:
+        SendAwaiter(Channel<void, Capacity>* channel) : channel_(channel) {}
+        bool await_ready() noexcept { return false; }
+        template <typename Promise> bool await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            promise_ = &handle.promise();
+            return channel_->send_impl(this);
+        }
+
+        auto await_resume() const { return state_; }
+        auto set_value(State state)
+        {
+            state_ = state;
+            return complete();
+        }
+
+      private:
+        Channel<void, Capacity>* channel_;
+        State state_{State::CLOSED};
+        friend class Channel;
+        friend class SendCase<void, Capacity>;
+    };
+
+    // 接收操作
+    class RecvAwaiter : public ChannelWaiter
+    {
+
+      public:
+        RecvAwaiter(Channel<void, Capacity>* channel) : channel_(channel) {}
+        auto await_ready() noexcept { return false; }
+
+        template <typename Promise> bool await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            promise_ = &handle.promise();
+            return channel_->recv_impl(this);
+        }
+
+        auto await_resume() const { return state_; }
+        auto set_value(State state)
+        {
+            state_ = state;
+            return complete();
+        }
+
+      private:
+        Channel<void, Capacity>* channel_;
+        State state_ = State::CLOSED;
+        friend class Channel;
+        friend class RecvCase<void, Capacity>;
+    };
+    Channel(size_t initial_size = 0) : size_(initial_size) { assert(initial_size <= Capacity); }
+    ~Channel() { close(); }
+    void close()
+    {
+        IntrusiveDList ready;
+        {
+            auto guard = std::lock_guard(mutex_);
+            if (is_closed_.load(std::memory_order_relaxed))
+            {
+                return;
+            }
+            is_closed_.store(true, std::memory_order_release);
+            while (auto send_awaiter = senders_.take())
+            {
+                send_awaiter->set_value(State::CLOSED);
+                ready.push_back(send_awaiter);
+            }
+            while (auto recv_awaiter = receivers_.take())
+            {
+                recv_awaiter->set_value(State::CLOSED);
+                ready.push_back(recv_awaiter);
+            }
+        }
+        ChannelWaiter::resume_all(ready);
+    }
+    auto recv() { return RecvAwaiter{this}; }
+    // 不挂起：有数据时取出一个并返回 true
+    bool try_recv();
+
+    auto send() { return SendAwaiter{this}; }
+    // 不挂起：有接收者在等或未满时发送并返回 true
+    bool try_send();
+
+  private:
+    bool send_impl(SendAwaiter* awaiter);
+    bool recv_impl(RecvAwaiter* awaiter);
+    bool is_closed() const { return is_closed_.load(std::memory_order_acquire); }
+    void wake_receivers();
+    void wake_senders();
+    void refill_locked(IntrusiveDList& ready);
+
+    // 以下供 select 使用，调用方持有 mutex_
+    bool poll_locked(RecvAwaiter* awaiter, Promise*& notify, IntrusiveDList& ready);
+    bool poll_locked(SendAwaiter* awaiter, Promise*& notify, IntrusiveDList& ready);
+    bool recheck_locked(RecvAwaiter* awaiter, IntrusiveDList& ready);
+    bool recheck_locked(SendAwaiter* awaiter, IntrusiveDList& ready);
+
+    // 只有计数的无锁队列，容量为 0 时始终为空，收发都走慢路径
+    MpmcRing<void, Capacity> size_;
+    std::atomic<bool> is_closed_{false};
+
+    Lock mutex_{};
+    WaitQueue<SendAwaiter> senders_;
+    WaitQueue<RecvAwaiter> receivers_;
+
+    friend class RecvCase<void, Capacity>;
+    friend class SendCase<void, Capacity>;
+};
+
+template <size_t Capacity> void Channel<void, Capacity>::wake_receivers()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (receivers_.waiting() == 0)
+    {
+        return;
+    }
+    IntrusiveDList ready;
+    {
+        std::lock_guard lock(mutex_);
+        while (auto recv_awaiter = receivers_.claim_front())
+        {
+            if (!size_.try_pop())
+            {
+                recv_awaiter->abort_claim();
+                break;
+            }
+            receivers_.pop();
+            recv_awaiter->set_value(State::OK);
+            ready.push_back(recv_awaiter);
+        }
+    }
+    ChannelWaiter::resume_all(ready);
+}
+
+template <size_t Capacity> void Channel<void, Capacity>::wake_senders()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (senders_.waiting() == 0)
+    {
+        return;
+    }
+    IntrusiveDList ready;
+    {
+        std::lock_guard lock(mutex_);
+        refill_locked(ready);
+    }
+    ChannelWaiter::resume_all(ready);
+}
+
+template <size_t Capacity> void Channel<void, Capacity>::refill_locked(IntrusiveDList& ready)
+{
+    while (auto send_awaiter = senders_.claim_front())
+    {
+        if (!size_.try_push())
+        {
+            send_awaiter->abort_claim();
+            break;
+        }
+        senders_.pop();
+        send_awaiter->set_value(State::OK);
+        ready.push_back(send_awaiter);
+    }
+}
+
+template <size_t Capacity> bool Channel<void, Capacity>::send_impl(SendAwaiter* send_awaiter)
+{
+    // channel关闭，不阻塞
+    if (is_closed())
+    {
+        return false;
+    }
+    // 快路径：没有协程挂起且未满
+    if (receivers_.waiting() == 0 && senders_.waiting() == 0 && size_.try_push())
+    {
+        send_awaiter->set_value(State::OK);
+        wake_receivers();
+        return false;
+    }
+    Promise* notify = nullptr;
+    IntrusiveDList ready;
+    bool suspend = false;
+    {
+        std::lock_guard lock(mutex_);
+        if (is_closed())
+        {
+            return false;
+        }
+        if (auto recv_awaiter = receivers_.take())
         {
-            auto recv_awaiter = static_cast<RecvAwaiter*>(recv_awaiters_.pop_front());
             notify = recv_awaiter->set_value(State::OK);
+            send_awaiter->set_value(State::OK);
         }
         else
         {
-            size_++;
+            // 先登记再重新检查，与 wake_senders 配对
+            senders_.push(send_awaiter);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            refill_locked(ready);
+            suspend = true;
+            if (!ready.empty() && ready.back() == send_awaiter)
+            {
+                ready.pop_back();
+                suspend = false;
+            }
         }
-        send_awaiter->set_value(State::OK);
     }
+    // 挂起后本协程可能已被其他线程恢复，之后只能访问局部变量
+    ChannelWaiter::resume_all(ready);
     if (notify)
     {
         co_spawn(notify);
     }
-    return false;
+    return suspend;
 }
+
 template <size_t Capacity> bool Channel<void, Capacity>::recv_impl(RecvAwaiter* recv_awaiter)
 {
+    if (size_.try_pop())
+    {
+        recv_awaiter->set_value(State::OK);
+        wake_senders();
+        return false;
+    }
     Promise* notify = nullptr;
+    bool taken = false;
     {
         std::lock_guard lock(mutex_);
-        // 关闭且为空，不阻塞
-        if (is_closed() && is_empty())
+        if (size_.try_pop())
+        {
+            taken = true;
+        }
+        else if (auto send_awaiter = senders_.take())
+        {
+            notify = send_awaiter->set_value(State::OK);
+        }
+        else if (is_closed())
         {
+            // 关闭且为空，不阻塞
             return false;
         }
-        // channel未关闭且为空，阻塞
-        if (is_empty())
+        else
         {
-            recv_awaiters_.push_back(recv_awaiter);
-            return true;
+            // channel未关闭且为空，阻塞
+            receivers_.push(recv_awaiter);
+            // 登记后重新检查，与 wake_receivers 配对
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!size_.try_pop())
+            {
+                return true;
+            }
+            receivers_.remove(recv_awaiter);
+            taken = true;
         }
-        // channel不空，唤醒
-        // 保持FIFO
-        if (!send_awaiters_.empty())
+    }
+    recv_awaiter->set_value(State::OK);
+    if (taken)
+    {
+        wake_senders();
+    }
+    else
+    {
+        co_spawn(notify);
+    }
+    return false;
+}
+
+template <size_t Capacity> bool Channel<void, Capacity>::try_recv()
+{
+    if (size_.try_pop())
+    {
+        wake_senders();
+        return true;
+    }
+    Promise* notify = nullptr;
+    {
+        std::lock_guard lock(mutex_);
+        if (!size_.try_pop())
         {
-            auto send_awaiter = static_cast<SendAwaiter*>(send_awaiters_.pop_front());
+            auto send_awaiter = senders_.take();
+            if (!send_awaiter)
+            {
+                return false;
+            }
             notify = send_awaiter->set_value(State::OK);
         }
-        else
+    }
+    if (notify)
+    {
+        co_spawn(notify);
+    }
+    else
+    {
+        wake_senders();
+    }
+    return true;
+}
+
+template <size_t Capacity> bool Channel<void, Capacity>::try_send()
+{
+    if (is_closed())
+    {
+        return false;
+    }
+    if (receivers_.waiting() == 0 && senders_.waiting() == 0 && size_.try_push())
+    {
+        wake_receivers();
+        return true;
+    }
+    Promise* notify = nullptr;
+    {
+        std::lock_guard lock(mutex_);
+        if (is_closed())
         {
-            size_--;
+            return false;
+        }
+        if (auto recv_awaiter = receivers_.take())
+        {
+            notify = recv_awaiter->set_value(State::OK);
+        }
+        else if (!senders_.empty() || !size_.try_push())
+        {
+            return false;
         }
-        recv_awaiter->set_value(State::OK);
     }
     if (notify)
     {
         co_spawn(notify);
     }
+    return true;
+}
+
+template <size_t Capacity>
+bool Channel<void, Capacity>::poll_locked(RecvAwaiter* recv_awaiter, Promise*& notify, IntrusiveDList&)
+{
+    if (size_.try_pop())
+    {
+        recv_awaiter->state_ = State::OK;
+        return true;
+    }
+    if (auto send_awaiter = senders_.take())
+    {
+        recv_awaiter->state_ = State::OK;
+        notify = send_awaiter->set_value(State::OK);
+        return true;
+    }
+    if (is_closed())
+    {
+        recv_awaiter->state_ = State::CLOSED;
+        return true;
+    }
     return false;
 }
 
+template <size_t Capacity>
+bool Channel<void, Capacity>::poll_locked(SendAwaiter* send_awaiter, Promise*& notify, IntrusiveDList&)
+{
+    if (is_closed())
+    {
+        send_awaiter->state_ = State::CLOSED;
+        return true;
+    }
+    if (auto recv_awaiter = receivers_.take())
+    {
+        notify = recv_awaiter->set_value(State::OK);
+        send_awaiter->state_ = State::OK;
+        return true;
+    }
+    if (senders_.empty() && size_.try_push())
+    {
+        send_awaiter->state_ = State::OK;
+        return true;
+    }
+    return false;
+}
+
+template <size_t Capacity> bool Channel<void, Capacity>::recheck_locked(RecvAwaiter* recv_awaiter, IntrusiveDList&)
+{
+    if (size_.try_pop())
+    {
+        receivers_.remove(recv_awaiter);
+        recv_awaiter->state_ = State::OK;
+        return true;
+    }
+    return false;
+}
+
+template <size_t Capacity>
+bool Channel<void, Capacity>::recheck_locked(SendAwaiter* send_awaiter, IntrusiveDList& ready)
+{
+    IntrusiveDList moved;
+    refill_locked(moved);
+    bool done = false;
+    while (!moved.empty())
+    {
+        auto waiter = static_cast<SendAwaiter*>(moved.pop_front());
+        if (waiter->selector_ && waiter->selector_ == send_awaiter->selector_)
+        {
+            done = true;
+        }
+        else
+        {
+            ready.push_back(waiter);
+        }
+    }
+    return done;
+}
+
+// SPSC channel 一侧的挂起登记，state_ 的低两位是阶段，其余位是登记序号
+// 登记分两步：先发布 Parking 再检查条件，条件不满足才提交为 Parked；
+// 对方只有看到 Parked 才恢复协程，看到 Parking 时只撤销登记，由挂起方自己继续，
+// 所以挂起方在提交之前访问 channel 是安全的，不会遇到已经恢复并销毁了 channel 的协程
+// 序号保证对方撤销时不会误取本方之后的新登记
+class SpscParker
+{
+  public:
+    // 返回是否挂起；ready 在登记之后检查，不能访问协程帧里的 awaiter
+    template <typename Ready> bool park(Promise* promise, Ready ready) noexcept
+    {
+        promise_ = promise;
+        auto parking = (((state_.load(std::memory_order_relaxed) >> 2) + 1) << 2) | Parking;
+        state_.store(parking, std::memory_order_release);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (ready())
+        {
+            // 对方可能已经撤销
+            state_.compare_exchange_strong(parking, parking & ~PhaseMask, std::memory_order_relaxed);
+            return false;
+        }
+        // 提交失败说明对方在检查期间撤销了登记，条件已经满足
+        return state_.compare_exchange_strong(parking, (parking & ~PhaseMask) | Parked, std::memory_order_acq_rel,
+                                              std::memory_order_relaxed);
+    }
+    // 推进下标或关闭之后调用，传入与 park 相同的 ready，返回需要恢复的协程
+    // 对方可能在取走这次写入/腾出的位置之后才登记，所以条件满足才撤销登记，否则留给之后的推进
+    template <typename Ready> Promise* take(Ready ready) noexcept
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        auto state = state_.load(std::memory_order_relaxed);
+        while ((state & PhaseMask) != Idle && ready())
+        {
+            if (state_.compare_exchange_weak(state, state & ~PhaseMask, std::memory_order_acq_rel,
+                                             std::memory_order_relaxed))
+            {
+                return (state & PhaseMask) == Parked ? promise_ : nullptr;
+            }
+        }
+        return nullptr;
+    }
+
+  private:
+    constexpr static uint64_t Idle = 0;
+    constexpr static uint64_t Parking = 1;
+    constexpr static uint64_t Parked = 2;
+    constexpr static uint64_t PhaseMask = 3;
+
+    std::atomic<uint64_t> state_{0};
+    Promise* promise_{};
+};
+
+/**
+ * @brief 单生产者单消费者 channel，同一时刻只能有一个协程发送、一个协程接收
+ * 数据放在按 acquire/release 下标同步的环形队列里，收发都不加锁；
+ * 一方挂起时在 sender_/receiver_ 登记，对方在推进下标之后检查并唤醒它，
+ * 两边在登记/推进与检查之间各有一个 seq_cst 栅栏，保证至少一方看到对方
+ * 不支持 select
+ */
+template <typename T, size_t Capacity> class Channel<T, Capacity, ChannelMode::SPSC>
+{
+    static_assert(!std::is_void_v<T>, "SPSC channel 不支持 void");
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "SPSC channel 的容量必须是不小于 2 的 2 的幂");
+
+  public:
+    class SendAwaiter
+    {
+      public:
+        SendAwaiter(Channel* channel, T&& value) : channel_(channel), value_(std::move(value)) {}
+        // 快路径：未满时直接写入，不挂起
+        bool await_ready() noexcept
+        {
+            if (channel_->is_closed())
+            {
+                done_ = true;
+                return true;
+            }
+            done_ = channel_->push(value_);
+            if (done_)
+            {
+                state_ = State::OK;
+                channel_->wake_receiver();
+            }
+            return done_;
+        }
+        template <typename Promise> bool await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            return channel_->sender_.park(&handle.promise(), [channel = channel_] { return channel->can_send(); });
+        }
+        // 只在有空位（只有一个生产者，空位不会被占走）或 channel 已关闭时被唤醒
+        auto await_resume()
+        {
+            if (!done_ && !channel_->is_closed())
+            {
+                [[maybe_unused]] bool pushed = channel_->push(value_);
+                assert(pushed);
+                state_ = State::OK;
+                channel_->wake_receiver();
+            }
+            return state_;
+        }
+
+      private:
+        Channel* channel_;
+        T value_;
+        State state_{State::CLOSED};
+        bool done_{false};
+        friend class Channel;
+    };
+
+    class RecvAwaiter
+    {
+      public:
+        RecvAwaiter(Channel* channel) : channel_(channel) {}
+        bool await_ready() noexcept
+        {
+            value_ = channel_->pop();
+            if (value_)
+            {
+                channel_->wake_sender();
+            }
+            return value_.has_value();
+        }
+        template <typename Promise> bool await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            return channel_->receiver_.park(&handle.promise(), [channel = channel_] { return channel->can_recv(); });
+        }
+        // 只在有数据（只有一个消费者）或 channel 已关闭时被唤醒
+        auto await_resume()
+        {
+            if (!value_)
+            {
+                value_ = channel_->pop();
+                if (!value_)
+                {
+                    return std::tuple<T, State>{T{}, State::CLOSED};
+                }
+                channel_->wake_sender();
+            }
+            return std::tuple<T, State>{std::move(*value_), State::OK};
+        }
+
+      private:
+        Channel* channel_;
+        std::optional<T> value_;
+        friend class Channel;
+    };
+
+    Channel() = default;
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+    ~Channel()
+    {
+        close();
+        while (pop())
+        {
+        }
+    }
+
+    auto send(T value) { return SendAwaiter{this, std::move(value)}; }
+    auto recv() { return RecvAwaiter{this}; }
+    // 不挂起：未满时发送并返回 true，失败（已满或已关闭）时 value 保持不变
+    bool try_send(T&& value)
+    {
+        if (is_closed() || !push(value))
+        {
+            return false;
+        }
+        wake_receiver();
+        return true;
+    }
+    // 不挂起：有数据时取出一个，否则返回空
+    auto try_recv() -> std::optional<T>
+    {
+        auto value = pop();
+        if (value)
+        {
+            wake_sender();
+        }
+        return value;
+    }
+    // 可以在任意协程调用；关闭前写入的数据仍然可以收到
+    void close()
+    {
+        if (closed_.exchange(true, std::memory_order_acq_rel))
+        {
+            return;
+        }
+        // 两边都取出来再恢复，恢复的协程可能销毁 channel
+        auto sender = sender_.take([this] { return can_send(); });
+        auto receiver = receiver_.take([this] { return can_recv(); });
+        if (sender)
+        {
+            co_spawn(sender);
+        }
+        if (receiver)
+        {
+            co_spawn(receiver);
+        }
+    }
+
+  private:
+    bool is_closed() const { return closed_.load(std::memory_order_acquire); }
+
+    // 只由生产者调用
+    bool push(T& value)
+    {
+        auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ == Capacity)
+        {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ == Capacity)
+            {
+                return false;
+            }
+        }
+        new (slot(tail)) T(std::move(value));
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    // 只由消费者调用
+    auto pop() -> std::optional<T>
+    {
+        auto head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_)
+        {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_)
+            {
+                return std::nullopt;
+            }
+        }
+        std::optional<T> value(std::move(*slot(head)));
+        slot(head)->~T();
+        head_.store(head + 1, std::memory_order_release);
+        return value;
+    }
+    bool full() const
+    {
+        return tail_.load(std::memory_order_relaxed) - head_.load(std::memory_order_acquire) == Capacity;
+    }
+    bool empty() const { return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_acquire); }
+    T* slot(size_t index) { return std::launder(reinterpret_cast<T*>(storage_ + (index & (Capacity - 1)) * sizeof(T))); }
+
+    // 挂起的一方被唤醒时必须满足的条件：有空位/有数据，或者已关闭
+    bool can_send() const { return !full() || is_closed(); }
+    bool can_recv() const { return !empty() || is_closed(); }
+    // 被恢复的协程可能立即销毁 channel，co_spawn 之后不能再访问 this
+    void wake_receiver()
+    {
+        if (auto promise = receiver_.take([this] { return can_recv(); }))
+        {
+            co_spawn(promise);
+        }
+    }
+    void wake_sender()
+    {
+        if (auto promise = sender_.take([this] { return can_send(); }))
+        {
+            co_spawn(promise);
+        }
+    }
+
+    alignas(T) std::byte storage_[Capacity * sizeof(T)];
+    std::atomic<bool> closed_{false};
+    // 生产者一侧：写下标、缓存的读下标、挂起的发送者
+    alignas(64) std::atomic<size_t> tail_{0};
+    size_t head_cache_{0};
+    SpscParker sender_;
+    // 消费者一侧
+    alignas(64) std::atomic<size_t> head_{0};
+    size_t tail_cache_{0};
+    SpscParker receiver_;
+};
+
 } // namespace utils
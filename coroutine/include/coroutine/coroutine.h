@@ -51,6 +51,13 @@ class Promise : public IntrusiveListNode
 {
   public:
     Promise() = default;
+    ~Promise()
+    {
+        if (pin_owner_)
+        {
+            release_pin(home_);
+        }
+    }
     void* operator new(std::size_t size)
     {
         // 调用 minimalloc 的分配函数 (如果是你自己的库，替换为对应的 malloc)
@@ -72,6 +79,14 @@ class Promise : public IntrusiveListNode
     void resume() { std::coroutine_handle<Promise>::from_promise(*this).resume(); }
     void destroy() { std::coroutine_handle<Promise>::from_promise(*this).destroy(); }
     void set_awaiter(CoroutineBase* awaiter) { awaiter_ = awaiter; }
+    // home P，-1 表示不固定
+    int home() const { return home_; }
+    void set_home(int home) { home_ = home; }
+    void pin(int home)
+    {
+        home_ = home;
+        pin_owner_ = true;
+    }
 
     // auto operator new(size_t size) -> void*
     // {
@@ -81,6 +96,9 @@ class Promise : public IntrusiveListNode
 
   protected:
     CoroutineBase* awaiter_{nullptr};
+    int home_{-1};
+    // 由 co_spawn_pinned 固定的根协程，销毁时归还计数
+    bool pin_owner_{false};
     friend class FinalAwaiter;
 };
 class CoroutineBase
@@ -102,6 +120,8 @@ class CoroutineBase
     {
         awaiter_promise_ = &handle.promise();
         self_promise_->set_awaiter(this);
+        // 子协程继承 home，IO 完成后仍回到同一个 P
+        self_promise_->set_home(awaiter_promise_->home());
         auto self_handle = std::coroutine_handle<Promise>::from_promise(*self_promise_);
         // 先置空
         self_promise_ = nullptr;
@@ -110,6 +130,7 @@ class CoroutineBase
 
   protected:
     friend void co_spawn(CoroutineBase&& coro);
+    friend void co_spawn_pinned(CoroutineBase&& coro, int home);
     friend class FinalAwaiter;
     Promise* self_promise_{};
     // await_suspend的handle
@@ -122,6 +143,12 @@ inline void co_spawn(CoroutineBase&& coro)
     coro.self_promise_ = nullptr;
     co_spawn(promise);
 }
+inline void co_spawn_pinned(CoroutineBase&& coro, int home)
+{
+    auto promise = coro.self_promise_;
+    coro.self_promise_ = nullptr;
+    co_spawn_pinned(promise, home);
+}
 template <typename T> class Coroutine;
 
 template <typename T = void> class Coroutine : public CoroutineBase
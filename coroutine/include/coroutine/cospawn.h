@@ -1,6 +1,27 @@
 #pragma once
+#include <cstddef>
 namespace utils
 {
 class Promise;
 void co_spawn(Promise* call, bool yield = false);
+
+// 为新协程选择 home P 的策略
+enum class PinPolicy
+{
+    NONE,
+    ROUND_ROBIN,
+    // 本地队列与固定协程数之和最小的 P
+    LEAST_LOADED,
+};
+// 按策略选出 home P 的 id，NONE 返回 -1
+int pick_processor(PinPolicy policy);
+// 将协程固定在 home P：它及其 co_await 的子协程始终在 home 上恢复，不参与窃取，
+// 只有 home 过载时才就地运行。home < 0 等价于 co_spawn
+void co_spawn_pinned(Promise* call, int home);
+// 当前线程所在 P 的 id，不在调度线程上返回 -1
+int current_processor();
+// P 的总数
+size_t processor_count();
+// 固定协程销毁时调用
+void release_pin(int home);
 } // namespace utils
\ No newline at end of file
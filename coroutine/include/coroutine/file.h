@@ -0,0 +1,146 @@
+#pragma once
+#include "coroutine/coroutine.h"
+#include "coroutine/syscall.h"
+#include <cstddef>
+#include <cstdint>
+#include <fcntl.h>
+#include <span>
+#include <string>
+#include <string_view>
+#include <sys/stat.h>
+#include <tuple>
+#include <unistd.h>
+#include <utility>
+
+namespace utils
+{
+// 基于 io_uring 的异步文件：open/stat/read/write/fsync/close 均不阻塞 Processor 线程
+class AsyncFile
+{
+  public:
+    AsyncFile() = default;
+    explicit AsyncFile(int fd) : fd_(fd) {}
+    ~AsyncFile()
+    {
+        // 兜底：未显式 co_await close() 时同步关闭
+        if (fd_ >= 0)
+        {
+            ::close(fd_);
+        }
+    }
+
+    AsyncFile(const AsyncFile&) = delete;
+    AsyncFile& operator=(const AsyncFile&) = delete;
+    AsyncFile(AsyncFile&& other) noexcept : fd_(std::exchange(other.fd_, -1)), offset_(other.offset_) {}
+    AsyncFile& operator=(AsyncFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            if (fd_ >= 0)
+                ::close(fd_);
+            fd_ = std::exchange(other.fd_, -1);
+            offset_ = other.offset_;
+        }
+        return *this;
+    }
+
+    // 打开文件，失败时返回的 AsyncFile 无效，error() 为 -errno
+    // resolve 对应 openat2 的 RESOLVE_* 标志，例如 RESOLVE_BENEATH 禁止逃出 dirfd
+    static auto open(std::string path, int flags = O_RDONLY, mode_t mode = 0, int dirfd = AT_FDCWD,
+                     uint64_t resolve = 0) -> Coroutine<AsyncFile>;
+
+    int fd() const { return fd_; }
+    bool is_valid() const { return fd_ >= 0; }
+    int error() const { return fd_ < 0 ? fd_ : 0; }
+
+    auto stat(struct statx& out)
+    {
+        return StatxAwaiter(fd_, "", AT_EMPTY_PATH, STATX_TYPE | STATX_SIZE | STATX_MTIME, &out);
+    }
+    auto read_at(std::span<char> buffer, uint64_t offset) noexcept
+    {
+        return ReadAtAwaiter(fd_, buffer.data(), buffer.size(), offset);
+    }
+    auto write_at(std::span<const char> buffer, uint64_t offset) noexcept
+    {
+        return WriteAtAwaiter(fd_, buffer.data(), buffer.size(), offset);
+    }
+    auto fsync(bool datasync = false) noexcept { return FsyncAwaiter(fd_, datasync); }
+    auto close() noexcept { return CloseAwaiter(std::exchange(fd_, -1)); }
+
+    // 流式读取：从内部游标处读取一块并推进游标，返回 0 表示文件结束
+    auto read_chunk(std::span<char> buffer) -> Coroutine<int>;
+    void seek(uint64_t offset) { offset_ = offset; }
+    uint64_t tell() const { return offset_; }
+
+    // 读取整个文件，按 chunk_size 分块提交，避免单个超大 SQE
+    // 返回 {内容, 0}，读取出错时返回 {已读到的内容, -errno}
+    auto read_all(size_t chunk_size = 64 * 1024) -> Coroutine<std::tuple<std::string, int>>;
+
+  private:
+    int fd_{-1};
+    // read_chunk 的读取游标
+    uint64_t offset_{0};
+};
+
+inline auto AsyncFile::open(std::string path, int flags, mode_t mode, int dirfd, uint64_t resolve)
+    -> Coroutine<AsyncFile>
+{
+    int fd = co_await OpenAtAwaiter(dirfd, std::move(path), flags | O_CLOEXEC, mode, resolve);
+    co_return AsyncFile{fd};
+}
+
+inline auto AsyncFile::read_chunk(std::span<char> buffer) -> Coroutine<int>
+{
+    int n = co_await read_at(buffer, offset_);
+    if (n > 0)
+    {
+        offset_ += n;
+    }
+    co_return n;
+}
+
+inline auto AsyncFile::read_all(size_t chunk_size) -> Coroutine<std::tuple<std::string, int>>
+{
+    std::string content;
+    struct statx stx{};
+    // 先按文件大小一次性分配，避免反复扩容
+    if (auto res = co_await stat(stx); res == 0)
+    {
+        content.reserve(stx.stx_size);
+    }
+    uint64_t offset = 0;
+    int error = 0;
+    while (true)
+    {
+        content.resize(offset + chunk_size);
+        int n = co_await read_at({content.data() + offset, chunk_size}, offset);
+        if (n == 0)
+        {
+            break;
+        }
+        if (n < 0)
+        {
+            error = n;
+            break;
+        }
+        offset += n;
+    }
+    content.resize(offset);
+    co_return std::tuple<std::string, int>{std::move(content), error};
+}
+
+// 打开 file_name，从开头读取最多 nbytes 字节后关闭；返回读到的字节数，失败返回 -errno
+// 打开和关闭同样经由 io_uring，不会因磁盘阻塞 Processor 线程
+inline auto read(std::string_view file_name, void* buf, size_t nbytes) -> Coroutine<int>
+{
+    auto file = co_await AsyncFile::open(std::string(file_name));
+    if (!file.is_valid())
+    {
+        co_return file.error();
+    }
+    int n = co_await file.read_at({static_cast<char*>(buf), nbytes}, 0);
+    co_await file.close();
+    co_return n;
+}
+} // namespace utils
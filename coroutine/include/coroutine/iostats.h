@@ -0,0 +1,70 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace utils
+{
+// IO 后端，启动时选定：环境变量 COROUTINE_IO_BACKEND=epoll 强制使用 epoll，
+// 否则使用 io_uring，不可用（例如被 seccomp 禁用）时自动回退到 epoll
+enum class IoBackend
+{
+    URING,
+    EPOLL,
+};
+
+// io_uring 提交批处理策略，对所有 P 生效
+struct SubmitPolicy
+{
+    // 累计多少个 SQE 后立即提交
+    size_t max_batch = 64;
+    // 最早的未提交 SQE 最多等待多久，繁忙的 P 也不会无限期拖延提交
+    std::chrono::microseconds max_delay{50};
+};
+
+// 单个 P 的提交统计
+struct SubmitStats
+{
+    uint64_t submit_calls = 0;
+    uint64_t submitted_sqes = 0;
+    // 第 i 个桶统计单次提交 SQE 数在 [2^i, 2^(i+1)) 的次数，最后一个桶包含更大的批次
+    std::array<uint64_t, 8> batch_histogram{};
+
+    double sqes_per_submit() const
+    {
+        return submit_calls == 0 ? 0.0 : static_cast<double>(submitted_sqes) / submit_calls;
+    }
+};
+
+// CQ 忙轮询策略：P 在阻塞等待前先在用户态查看 CQ 一段时间，省掉一次睡眠/唤醒
+struct SpinPolicy
+{
+    // 轮询窗口上限，0 表示关闭忙轮询
+    std::chrono::microseconds max_spin{50};
+    // 根据命中情况自适应调整窗口，关闭时每次都轮询 max_spin
+    bool adaptive = true;
+};
+
+// 单个 P 的 CQ 轮询统计
+struct PollStats
+{
+    // 轮询窗口内等到了完成事件
+    uint64_t spin_hits = 0;
+    // 轮询超时，转入阻塞等待
+    uint64_t spin_misses = 0;
+    uint64_t blocking_waits = 0;
+    // 本 P 的 CQ 被其他 P 代为收割的完成事件数
+    uint64_t harvested_cqes = 0;
+    // 当前学习到的轮询窗口
+    std::chrono::nanoseconds spin_window{0};
+};
+
+auto io_backend() -> IoBackend;
+void set_submit_policy(SubmitPolicy policy);
+void set_spin_policy(SpinPolicy policy);
+// 按 Processor id 排列
+auto submit_stats() -> std::vector<SubmitStats>;
+auto poll_stats() -> std::vector<PollStats>;
+} // namespace utils
@@ -0,0 +1,268 @@
+#pragma once
+
+#include "coroutine/spinlock.h"
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <span>
+#include <utility>
+
+namespace utils
+{
+// 容量在运行时指定的 channel，同 std::dynamic_extent
+inline constexpr size_t DynamicCapacity = std::dynamic_extent;
+
+/**
+ * @brief 有界无锁多生产者多消费者环形队列（按槽位序号同步）
+ * 每个槽位带一个序号：等于写位置时可写，等于写位置 + 1 时可读，读完后推进一圈
+ * 生产者和消费者只在 head_/tail_ 上 CAS，槽位内的数据由序号的 acquire/release 发布
+ * 序号方案要求槽位数是不小于 2 的 2 的幂，Capacity 不满足时向上取整，再按 tail_ - head_ 限制容量
+ * @tparam Capacity 最多存放的元素个数，至少为 1
+ */
+template <typename T, size_t Capacity> class MpmcRing
+{
+    static_assert(Capacity >= 1, "Capacity 至少为 1");
+
+  public:
+    MpmcRing() noexcept
+    {
+        for (size_t i = 0; i < Slots; ++i)
+        {
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+    MpmcRing(const MpmcRing&) = delete;
+    MpmcRing& operator=(const MpmcRing&) = delete;
+    ~MpmcRing()
+    {
+        while (try_pop())
+        {
+        }
+    }
+
+    // 成功时从 value 移动构造，失败（已满）时 value 保持不变
+    bool try_push(T& value)
+    {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            auto& slot = slots_[pos & MASK];
+            size_t seq = slot.seq.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0)
+            {
+                // 槽位有空闲但已达到容量；head_ 在 pos 之后读取，可能比 pos 还新，按有符号比较
+                if constexpr (Slots != Capacity)
+                {
+                    auto size = static_cast<intptr_t>(pos - head_.load(std::memory_order_acquire));
+                    if (size >= static_cast<intptr_t>(Capacity))
+                    {
+                        return false;
+                    }
+                }
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    new (slot.ptr()) T(std::move(value));
+                    slot.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0)
+            {
+                // 这一圈的消费者还没读走
+                return false;
+            }
+            else
+            {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    auto try_pop() -> std::optional<T>
+    {
+        size_t pos = head_.load(std::memory_order_relaxed);
+        while (true)
+        {
+            auto& slot = slots_[pos & MASK];
+            size_t seq = slot.seq.load(std::memory_order_acquire);
+            auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0)
+            {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    std::optional<T> value(std::move(*slot.ptr()));
+                    slot.ptr()->~T();
+                    slot.seq.store(pos + Slots, std::memory_order_release);
+                    return value;
+                }
+            }
+            else if (diff < 0)
+            {
+                // 生产者还没写入
+                return std::nullopt;
+            }
+            else
+            {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // 并发时只是近似值
+    bool empty() const noexcept
+    {
+        return head_.load(std::memory_order_relaxed) == tail_.load(std::memory_order_relaxed);
+    }
+
+  private:
+    static constexpr size_t Slots = std::bit_ceil(std::max<size_t>(Capacity, 2));
+    static constexpr size_t MASK = Slots - 1;
+
+    struct Slot
+    {
+        std::atomic<size_t> seq;
+        alignas(T) std::byte storage[sizeof(T)];
+        T* ptr() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+    };
+
+    Slot slots_[Slots];
+    // 生产者和消费者各占一个缓存行，避免伪共享
+    alignas(64) std::atomic<size_t> tail_{0};
+    alignas(64) std::atomic<size_t> head_{0};
+};
+
+/**
+ * @brief 容量在运行时指定、存储按需在堆上增长的有界队列，接口与 MpmcRing 相同
+ * 第一次写入时才分配，满了按 2 倍扩容直到 capacity；元素降到四分之一以下时减半，最少保留 MinSlots 个槽位
+ * 扩缩容要搬移元素，所以用自旋锁而不是按槽位序号同步，临界区只有一次移动（偶尔一次搬移）
+ */
+template <typename T> class DynamicRing
+{
+  public:
+    explicit DynamicRing(size_t capacity) noexcept : capacity_(capacity) {}
+    DynamicRing(const DynamicRing&) = delete;
+    DynamicRing& operator=(const DynamicRing&) = delete;
+    ~DynamicRing()
+    {
+        while (try_pop())
+        {
+        }
+        std::allocator<T>().deallocate(slots_, slot_count_);
+    }
+
+    // 成功时从 value 移动构造，失败（已满）时 value 保持不变
+    bool try_push(T& value)
+    {
+        std::lock_guard lock(lock_);
+        auto size = size_.load(std::memory_order_relaxed);
+        if (size == capacity_)
+        {
+            return false;
+        }
+        if (size == slot_count_)
+        {
+            resize(slot_count_ == 0 ? std::min(MinSlots, std::bit_ceil(capacity_)) : slot_count_ * 2, size);
+        }
+        new (&slots_[(head_ + size) & (slot_count_ - 1)]) T(std::move(value));
+        size_.store(size + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    auto try_pop() -> std::optional<T>
+    {
+        std::lock_guard lock(lock_);
+        auto size = size_.load(std::memory_order_relaxed);
+        if (size == 0)
+        {
+            return std::nullopt;
+        }
+        auto& slot = slots_[head_];
+        std::optional<T> value(std::move(slot));
+        slot.~T();
+        head_ = (head_ + 1) & (slot_count_ - 1);
+        size_.store(--size, std::memory_order_relaxed);
+        if (slot_count_ > MinSlots && size <= slot_count_ / 4)
+        {
+            resize(slot_count_ / 2, size);
+        }
+        return value;
+    }
+
+    // 并发时只是近似值
+    bool empty() const noexcept { return size_.load(std::memory_order_relaxed) == 0; }
+    size_t capacity() const noexcept { return capacity_; }
+
+  private:
+    constexpr static size_t MinSlots = 16;
+
+    // 持锁调用，槽位数始终是 2 的幂，可以大于 capacity_
+    void resize(size_t slot_count, size_t size)
+    {
+        auto slots = std::allocator<T>().allocate(slot_count);
+        for (size_t i = 0; i < size; ++i)
+        {
+            auto& slot = slots_[(head_ + i) & (slot_count_ - 1)];
+            new (&slots[i]) T(std::move(slot));
+            slot.~T();
+        }
+        std::allocator<T>().deallocate(slots_, slot_count_);
+        slots_ = slots;
+        slot_count_ = slot_count;
+        head_ = 0;
+    }
+
+    SpinLock lock_;
+    T* slots_{nullptr};
+    size_t slot_count_{0};
+    size_t head_{0};
+    // 只在持锁时修改，empty() 不加锁读取
+    std::atomic<size_t> size_{0};
+    size_t capacity_;
+};
+
+/**
+ * @brief void 特化：只有计数，没有数据
+ */
+template <size_t Capacity> class MpmcRing<void, Capacity>
+{
+  public:
+    explicit MpmcRing(size_t initial_size = 0) noexcept : size_(initial_size) {}
+
+    bool try_push()
+    {
+        size_t size = size_.load(std::memory_order_relaxed);
+        while (size < Capacity)
+        {
+            if (size_.compare_exchange_weak(size, size + 1, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+    bool try_pop()
+    {
+        size_t size = size_.load(std::memory_order_relaxed);
+        while (size > 0)
+        {
+            if (size_.compare_exchange_weak(size, size - 1, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+    bool empty() const noexcept { return size_.load(std::memory_order_relaxed) == 0; }
+
+  private:
+    std::atomic<size_t> size_;
+};
+
+} // namespace utils
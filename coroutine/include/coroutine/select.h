@@ -0,0 +1,334 @@
+#pragma once
+
+#include "coroutine/channel.h"
+#include "coroutine/coroutine.h"
+#include "coroutine/cospawn.h"
+#include "coroutine/syscall.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace utils
+{
+
+// select 的接收分支，out 为空时丢弃收到的值
+template <typename T, size_t Capacity> class RecvCase
+{
+  public:
+    using Out = std::conditional_t<std::is_void_v<T>, void*, T*>;
+    RecvCase(Channel<T, Capacity>& channel, Out out) : channel_(&channel), awaiter_(&channel), out_(out) {}
+
+  private:
+    using Awaiter = typename Channel<T, Capacity>::RecvAwaiter;
+
+    std::mutex* mutex() const { return &channel_->mutex_; }
+    bool poll_locked(Promise*& notify, IntrusiveDList& ready) { return channel_->poll_locked(&awaiter_, notify, ready); }
+    void park_locked(Promise* promise, Selector* selector, int index)
+    {
+        awaiter_.promise_ = promise;
+        awaiter_.selector_ = selector;
+        awaiter_.case_index_ = index;
+        channel_->receivers_.push(&awaiter_);
+    }
+    bool recheck_locked(IntrusiveDList& ready) { return channel_->recheck_locked(&awaiter_, ready); }
+    void unpark_locked() { channel_->receivers_.remove(&awaiter_); }
+    void cancel()
+    {
+        std::lock_guard lock(channel_->mutex_);
+        unpark_locked();
+    }
+    // 取走一个数据后队列有了空位，补进挂起的发送者
+    void after()
+    {
+        if constexpr (Capacity > 0)
+        {
+            channel_->wake_senders();
+        }
+    }
+    State finish()
+    {
+        if constexpr (!std::is_void_v<T>)
+        {
+            if (out_ && awaiter_.state_ == State::OK)
+            {
+                *out_ = std::move(awaiter_.value_);
+            }
+        }
+        return awaiter_.state_;
+    }
+
+    Channel<T, Capacity>* channel_;
+    Awaiter awaiter_;
+    Out out_;
+    template <typename... Cases> friend class SelectAwaiter;
+};
+
+// select 的发送分支，分支没有被选中时值随 select 一起销毁
+template <typename T, size_t Capacity> class SendCase
+{
+  public:
+    using Awaiter = typename Channel<T, Capacity>::SendAwaiter;
+    // awaiter 由 channel.send(...) 构造，还没有 co_await
+    SendCase(Channel<T, Capacity>& channel, Awaiter&& awaiter) : channel_(&channel), awaiter_(std::move(awaiter)) {}
+
+  private:
+    std::mutex* mutex() const { return &channel_->mutex_; }
+    bool poll_locked(Promise*& notify, IntrusiveDList& ready) { return channel_->poll_locked(&awaiter_, notify, ready); }
+    void park_locked(Promise* promise, Selector* selector, int index)
+    {
+        awaiter_.promise_ = promise;
+        awaiter_.selector_ = selector;
+        awaiter_.case_index_ = index;
+        channel_->senders_.push(&awaiter_);
+    }
+    bool recheck_locked(IntrusiveDList& ready) { return channel_->recheck_locked(&awaiter_, ready); }
+    void unpark_locked() { channel_->senders_.remove(&awaiter_); }
+    void cancel()
+    {
+        std::lock_guard lock(channel_->mutex_);
+        unpark_locked();
+    }
+    // 写入队列后唤醒挂起的接收者
+    void after()
+    {
+        if constexpr (Capacity > 0)
+        {
+            channel_->wake_receivers();
+        }
+    }
+    State finish() { return awaiter_.state_; }
+
+    Channel<T, Capacity>* channel_;
+    Awaiter awaiter_;
+    template <typename... Cases> friend class SelectAwaiter;
+};
+
+// 没有分支就绪时立即选中，不挂起
+struct DefaultCase
+{
+};
+inline constexpr DefaultCase default_case{};
+
+template <typename T, size_t Capacity> auto recv_case(Channel<T, Capacity>& channel, T* out)
+{
+    return RecvCase<T, Capacity>(channel, out);
+}
+template <typename T, size_t Capacity> auto recv_case(Channel<T, Capacity>& channel)
+{
+    return RecvCase<T, Capacity>(channel, nullptr);
+}
+template <typename T, size_t Capacity> auto send_case(Channel<T, Capacity>& channel, T value)
+{
+    return SendCase<T, Capacity>(channel, channel.send(std::move(value)));
+}
+template <size_t Capacity> auto send_case(Channel<void, Capacity>& channel)
+{
+    return SendCase<void, Capacity>(channel, channel.send());
+}
+
+struct SelectResult
+{
+    // 选中的分支在 select 参数中的下标
+    size_t index;
+    // 接收分支为 CLOSED 时 channel 已关闭且为空；default 分支为 OK
+    State state;
+};
+
+/**
+ * @brief 同时等待多个 channel 的收发，只完成其中一个分支，语义同 Go 的 select
+ * 按地址顺序锁住所有 channel，从轮换的起点依次检查分支，有就绪的立即完成；
+ * 都没就绪且有 default 分支时选中 default，否则把每个分支的节点挂到对应 channel 的等待队列上，
+ * 第一个完成的分支通过 Selector 占住整个 select，其余分支在恢复后摘除
+ */
+template <typename... Cases> class SelectAwaiter
+{
+    constexpr static size_t N = sizeof...(Cases);
+    constexpr static bool HasDefault = (std::is_same_v<Cases, DefaultCase> || ...);
+    constexpr static size_t ChannelCount = N - (std::is_same_v<Cases, DefaultCase> + ... + 0);
+    static_assert((std::is_same_v<Cases, DefaultCase> + ... + 0) <= 1, "select 最多只能有一个 default 分支");
+
+  public:
+    explicit SelectAwaiter(Cases&&... cases) : cases_(std::move(cases)...) {}
+    SelectAwaiter(const SelectAwaiter&) = delete;
+    SelectAwaiter& operator=(const SelectAwaiter&) = delete;
+
+    bool await_ready() const noexcept { return false; }
+    template <typename Promise> bool await_suspend(std::coroutine_handle<Promise> handle) noexcept
+    {
+        return select_impl(&handle.promise());
+    }
+    SelectResult await_resume()
+    {
+        auto winner = static_cast<size_t>(selector_.winner());
+        if (parked_)
+        {
+            // 挂起后由某个 channel 完成，其余分支还在各自的等待队列里
+            for_each_channel([&](auto& c, size_t i) {
+                if (i != winner)
+                {
+                    c.cancel();
+                }
+            });
+        }
+        State state = State::OK;
+        visit(winner, [&](auto& c) {
+            if constexpr (!std::is_same_v<std::decay_t<decltype(c)>, DefaultCase>)
+            {
+                state = c.finish();
+            }
+        });
+        return {winner, state};
+    }
+
+  private:
+    // 返回是否挂起，挂起后本协程可能已在其他线程恢复，只能访问局部变量
+    bool select_impl(Promise* promise)
+    {
+        std::array<std::mutex*, ChannelCount> locks{};
+        size_t lock_count = 0;
+        for_each_channel([&](auto& c, size_t) { locks[lock_count++] = c.mutex(); });
+        // 多个 select 以相同顺序加锁，避免死锁；同一个 channel 出现多次时只锁一次
+        std::sort(locks.begin(), locks.end());
+        lock_count = std::unique(locks.begin(), locks.end()) - locks.begin();
+        for (size_t i = 0; i < lock_count; ++i)
+        {
+            locks[i]->lock();
+        }
+
+        Promise* notify = nullptr;
+        IntrusiveDList ready;
+        // 轮换检查的起点，多个分支同时就绪时不总是选中前面的
+        thread_local size_t next_start = 0;
+        size_t start = next_start++;
+        int winner = -1;
+        for (size_t k = 0; k < N && winner < 0; ++k)
+        {
+            auto i = (start + k) % N;
+            visit(i, [&](auto& c) {
+                if constexpr (!std::is_same_v<std::decay_t<decltype(c)>, DefaultCase>)
+                {
+                    if (c.poll_locked(notify, ready))
+                    {
+                        winner = static_cast<int>(i);
+                    }
+                }
+            });
+        }
+        if (winner < 0 && HasDefault)
+        {
+            winner = static_cast<int>(default_index());
+        }
+        bool suspend = false;
+        if (winner >= 0)
+        {
+            selector_.set_winner(winner);
+        }
+        else
+        {
+            for_each_channel([&](auto& c, size_t i) { c.park_locked(promise, &selector_, static_cast<int>(i)); });
+            // 登记之后重新检查无锁队列，与快路径的 wake_* 配对
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            for_each_channel([&](auto& c, size_t i) {
+                if (winner < 0 && c.recheck_locked(ready))
+                {
+                    // 同一个 channel 上的多个发送分支按挂起顺序补进队列，完成的不一定是当前分支
+                    winner = selector_.winner() >= 0 ? selector_.winner() : static_cast<int>(i);
+                }
+            });
+            if (winner >= 0)
+            {
+                selector_.set_winner(winner);
+                for_each_channel([&](auto& c, size_t i) {
+                    if (i != static_cast<size_t>(winner))
+                    {
+                        c.unpark_locked();
+                    }
+                });
+            }
+            else
+            {
+                parked_ = true;
+                suspend = true;
+            }
+        }
+        for (size_t i = lock_count; i > 0; --i)
+        {
+            locks[i - 1]->unlock();
+        }
+
+        ChannelWaiter::resume_all(ready);
+        if (suspend)
+        {
+            return true;
+        }
+        if (notify)
+        {
+            co_spawn(notify);
+        }
+        visit(winner, [](auto& c) {
+            if constexpr (!std::is_same_v<std::decay_t<decltype(c)>, DefaultCase>)
+            {
+                c.after();
+            }
+        });
+        return false;
+    }
+
+    constexpr static size_t default_index()
+    {
+        constexpr std::array<bool, N> is_default{std::is_same_v<Cases, DefaultCase>...};
+        return std::find(is_default.begin(), is_default.end(), true) - is_default.begin();
+    }
+    template <typename F> void visit(size_t index, F&& f)
+    {
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+            ((index == Is ? (f(std::get<Is>(cases_)), true) : false) || ...);
+        }(std::index_sequence_for<Cases...>{});
+    }
+    // 按下标顺序访问除 default 以外的分支
+    template <typename F> void for_each_channel(F&& f)
+    {
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+            (
+                [&] {
+                    if constexpr (!std::is_same_v<std::tuple_element_t<Is, std::tuple<Cases...>>, DefaultCase>)
+                    {
+                        f(std::get<Is>(cases_), Is);
+                    }
+                }(),
+                ...);
+        }(std::index_sequence_for<Cases...>{});
+    }
+
+    std::tuple<Cases...> cases_;
+    Selector selector_;
+    bool parked_{false};
+};
+
+template <typename... Cases> auto select(Cases... cases)
+{
+    static_assert(sizeof...(Cases) > 0, "select 至少需要一个分支");
+    return SelectAwaiter<Cases...>(std::move(cases)...);
+}
+
+// duration 之后可以接收一次，用作 select 的超时分支，同 Go 的 time.After
+template <typename Rep, typename Period> auto after(std::chrono::duration<Rep, Period> timeout)
+{
+    auto channel = std::make_shared<Channel<void, 1>>();
+    // 定时协程持有 channel，select 提前返回时也能安全地写入
+    auto timer = [](std::shared_ptr<Channel<void, 1>> channel, std::chrono::nanoseconds timeout) -> Coroutine<> {
+        co_await delay(timeout);
+        co_await channel->send();
+    };
+    co_spawn(timer(channel, std::chrono::duration_cast<std::chrono::nanoseconds>(timeout)));
+    return channel;
+}
+
+} // namespace utils
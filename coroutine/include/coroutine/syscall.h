@@ -1,14 +1,24 @@
 #pragma once
 
 #include "coroutine/coroutine.h"
+#include <cerrno>
+#include <chrono>
+#include <concepts>
 #include <ctime>
 #include <fcntl.h>
+#include <linux/openat2.h>
+#include <linux/time_types.h>
+#include <poll.h>
 #include <print>
+#include <string>
 #include <string_view>
 #include <sys/socket.h>
+#include <sys/stat.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <type_traits>
 #include <unistd.h>
+struct io_uring_sqe;
 namespace utils
 {
 
@@ -20,7 +30,19 @@ enum class SysCallType
     WRITE,
     RECV,
     SEND,
-    DELAY
+    DELAY,
+    READV,
+    WRITEV,
+    RECVMSG,
+    SENDMSG,
+    OPENAT,
+    STATX,
+    READ_AT,
+    WRITE_AT,
+    FSYNC,
+    CLOSE,
+    POLL,
+    URING_OP
 };
 class IOContext;
 template <typename T> bool process(T* awaiter);
@@ -98,20 +120,6 @@ class ReadAwaiter : public SysAwaiter<ReadAwaiter>
     friend class IOContext;
 };
 
-class FileReadAwaiter : public ReadAwaiter
-{
-  public:
-    FileReadAwaiter(std::string_view file_path, void* buf, size_t nbytes)
-        : ReadAwaiter(open(file_path.data(), O_RDONLY), buf, nbytes)
-    {
-    }
-    ~FileReadAwaiter()
-    {
-        if (fd_ != -1)
-            close(fd_);
-    }
-};
-
 class WriteAwaiter : public SysAwaiter<WriteAwaiter>
 {
   public:
@@ -198,13 +206,296 @@ class SendAwaiter : public SysAwaiter<SendAwaiter>
     friend class IOContext;
 };
 
+// 跳过已经写完的 iovec，并调整剩余第一个 iovec 的起点
+inline void advance_iovec(iovec*& iov, size_t& iovcnt, size_t nbytes) noexcept
+{
+    while (iovcnt > 0 && nbytes >= iov->iov_len)
+    {
+        nbytes -= iov->iov_len;
+        ++iov;
+        --iovcnt;
+    }
+    if (iovcnt > 0)
+    {
+        iov->iov_base = static_cast<char*>(iov->iov_base) + nbytes;
+        iov->iov_len -= nbytes;
+    }
+}
+
+class ReadvAwaiter : public SysAwaiter<ReadvAwaiter>
+{
+  public:
+    ReadvAwaiter(int fd, const iovec* iov, size_t iovcnt)
+        : SysAwaiter(SysCallType::READV), fd_(fd), iov_(iov), iovcnt_(iovcnt)
+    {
+    }
+
+  private:
+    int fd_;
+    const iovec* iov_;
+    size_t iovcnt_;
+    friend class IOContext;
+};
+
+// 注意：部分写入时会原地修改调用者的 iovec 数组
+class WritevAwaiter : public SysAwaiter<WritevAwaiter>
+{
+  public:
+    WritevAwaiter(int fd, iovec* iov, size_t iovcnt)
+        : SysAwaiter(SysCallType::WRITEV), fd_(fd), iov_(iov), iovcnt_(iovcnt)
+    {
+    }
+    auto set_value(int result) -> Promise* override
+    {
+        if (result <= 0)
+        {
+            return promise_;
+        }
+        // 如果是部分写入，继续写剩余数据
+        advance_iovec(iov_, iovcnt_, result);
+        result_ += result;
+        if (iovcnt_ == 0)
+        {
+            return promise_;
+        }
+        process(this);
+        return nullptr; // 不立即恢复，等待下一次写入完成
+    }
+
+  private:
+    int fd_;
+    iovec* iov_;
+    size_t iovcnt_;
+    friend class IOContext;
+};
+
+class RecvmsgAwaiter : public SysAwaiter<RecvmsgAwaiter>
+{
+  public:
+    RecvmsgAwaiter(int fd, msghdr* msg, int flags) : SysAwaiter(SysCallType::RECVMSG), fd_(fd), msg_(msg), flags_(flags)
+    {
+    }
+
+  private:
+    int fd_;
+    msghdr* msg_;
+    int flags_;
+    friend class IOContext;
+};
+
+// 注意：部分写入时会原地修改 msg 的 msg_iov/msg_iovlen
+class SendmsgAwaiter : public SysAwaiter<SendmsgAwaiter>
+{
+  public:
+    SendmsgAwaiter(int fd, msghdr* msg, int flags) : SysAwaiter(SysCallType::SENDMSG), fd_(fd), msg_(msg), flags_(flags)
+    {
+        // 与 SendAwaiter 一致：防止对端关闭时崩溃，屏蔽 MSG_DONTWAIT
+        flags_ = (flags | MSG_NOSIGNAL) & ~MSG_DONTWAIT;
+    }
+    auto set_value(int result) -> Promise* override
+    {
+        if (result <= 0)
+        {
+            return promise_;
+        }
+        size_t iovcnt = msg_->msg_iovlen;
+        advance_iovec(msg_->msg_iov, iovcnt, result);
+        msg_->msg_iovlen = iovcnt;
+        result_ += result;
+        if (iovcnt == 0)
+        {
+            return promise_;
+        }
+        // 辅助数据只随第一段发送
+        msg_->msg_control = nullptr;
+        msg_->msg_controllen = 0;
+        process(this);
+        return nullptr;
+    }
+
+  private:
+    int fd_;
+    msghdr* msg_;
+    int flags_;
+    friend class IOContext;
+};
+
+// ==========================================================
+// 文件 IO：全部经由 io_uring，不阻塞 Processor 线程
+// ==========================================================
+class OpenAtAwaiter : public SysAwaiter<OpenAtAwaiter>
+{
+  public:
+    OpenAtAwaiter(int dirfd, std::string path, int flags, mode_t mode, uint64_t resolve)
+        : SysAwaiter(SysCallType::OPENAT), dirfd_(dirfd), path_(std::move(path))
+    {
+        how_.flags = flags;
+        how_.mode = (flags & (O_CREAT | O_TMPFILE)) ? mode : 0;
+        how_.resolve = resolve;
+    }
+
+  private:
+    int dirfd_;
+    // 提交可能被批量延迟，路径必须由 awaiter 持有
+    std::string path_;
+    open_how how_{};
+    friend class IOContext;
+};
+
+class StatxAwaiter : public SysAwaiter<StatxAwaiter>
+{
+  public:
+    StatxAwaiter(int dirfd, std::string path, int flags, unsigned mask, struct statx* buf)
+        : SysAwaiter(SysCallType::STATX), dirfd_(dirfd), path_(std::move(path)), flags_(flags), mask_(mask), buf_(buf)
+    {
+    }
+
+  private:
+    int dirfd_;
+    std::string path_;
+    int flags_;
+    unsigned mask_;
+    struct statx* buf_;
+    friend class IOContext;
+};
+
+// 指定偏移读取，读到文件末尾时返回的字节数可能少于请求
+class ReadAtAwaiter : public SysAwaiter<ReadAtAwaiter>
+{
+  public:
+    ReadAtAwaiter(int fd, void* buf, size_t nbytes, uint64_t offset)
+        : SysAwaiter(SysCallType::READ_AT), fd_(fd), buf_(buf), nbytes_(nbytes), offset_(offset)
+    {
+    }
+
+  private:
+    int fd_;
+    void* buf_;
+    size_t nbytes_;
+    uint64_t offset_;
+    friend class IOContext;
+};
+
+class WriteAtAwaiter : public SysAwaiter<WriteAtAwaiter>
+{
+  public:
+    WriteAtAwaiter(int fd, const void* buf, size_t nbytes, uint64_t offset)
+        : SysAwaiter(SysCallType::WRITE_AT), fd_(fd), buf_(buf), nbytes_(nbytes), offset_(offset)
+    {
+    }
+    auto set_value(int result) -> Promise* override
+    {
+        if (result <= 0)
+        {
+            return promise_;
+        }
+        // 如果是部分写入，从新的偏移继续写剩余数据
+        buf_ = static_cast<const char*>(buf_) + result;
+        nbytes_ -= result;
+        offset_ += result;
+        result_ += result;
+        if (nbytes_ == 0)
+        {
+            return promise_;
+        }
+        process(this);
+        return nullptr;
+    }
+
+  private:
+    int fd_;
+    const void* buf_;
+    size_t nbytes_;
+    uint64_t offset_;
+    friend class IOContext;
+};
+
+class FsyncAwaiter : public SysAwaiter<FsyncAwaiter>
+{
+  public:
+    FsyncAwaiter(int fd, bool datasync) : SysAwaiter(SysCallType::FSYNC), fd_(fd), datasync_(datasync) {}
+
+  private:
+    int fd_;
+    bool datasync_;
+    friend class IOContext;
+};
+
+class CloseAwaiter : public SysAwaiter<CloseAwaiter>
+{
+  public:
+    CloseAwaiter(int fd) : SysAwaiter(SysCallType::CLOSE), fd_(fd) {}
+
+  private:
+    int fd_;
+    friend class IOContext;
+};
+
+// 只等待 fd 就绪，不读写数据，结果为就绪的事件掩码
+// 连接空闲时先等待可读再借用缓冲区，等待期间不占用内存
+class PollAwaiter : public SysAwaiter<PollAwaiter>
+{
+  public:
+    PollAwaiter(int fd, short events) : SysAwaiter(SysCallType::POLL), fd_(fd), events_(events) {}
+
+  private:
+    int fd_;
+    short events_;
+    // epoll 后端：已挂起过，被事件唤醒重试时不必再检查一次
+    bool parked_{false};
+    friend class IOContext;
+};
+
+// ==========================================================
+// 通用 io_uring 操作：由调用方准备 SQE，复用内置操作的 pending 队列背压与 CQE 分发
+// 新增系统调用无需再增加 SysCallType 和 IOContext 分支
+// ==========================================================
+class UringOpAwaiterBase : public SysAwaiter<UringOpAwaiterBase>
+{
+  public:
+    // 普通函数指针，准备 SQE 时没有虚函数调用
+    using PrepFunc = void (*)(UringOpAwaiterBase*, io_uring_sqe*);
+    explicit UringOpAwaiterBase(PrepFunc prep) : SysAwaiter(SysCallType::URING_OP), prep_(prep) {}
+
+  private:
+    PrepFunc prep_;
+    friend class IOContext;
+};
+
+template <typename F> class UringOpAwaiter : public UringOpAwaiterBase
+{
+  public:
+    explicit UringOpAwaiter(F prep) : UringOpAwaiterBase(&UringOpAwaiter::prep_impl), prep_func_(std::move(prep)) {}
+
+  private:
+    static void prep_impl(UringOpAwaiterBase* self, io_uring_sqe* sqe)
+    {
+        static_cast<UringOpAwaiter*>(self)->prep_func_(sqe);
+    }
+    // 可能进入 pending 队列延迟准备，所以按值保存
+    F prep_func_;
+};
+
+// 延时：不低于时间轮精度的交给时间轮，更短的由 io_uring 的 IORING_OP_TIMEOUT 提供微秒级精度
 class DelayAwaiter : public SysAwaiter<DelayAwaiter>
 {
   public:
-    DelayAwaiter(double timeout) : SysAwaiter(SysCallType::DELAY), timeout_(timeout) {}
+    // 单位为秒
+    DelayAwaiter(double timeout)
+        : DelayAwaiter(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<double>(timeout)))
+    {
+    }
+    DelayAwaiter(std::chrono::nanoseconds timeout) : SysAwaiter(SysCallType::DELAY), timeout_(timeout) {}
+    auto set_value(int result) -> Promise* override
+    {
+        // IORING_OP_TIMEOUT 正常到期返回 -ETIME
+        return SysAwaiterBase::set_value(result == -ETIME ? 0 : result);
+    }
 
   private:
-    double timeout_;
+    std::chrono::nanoseconds timeout_;
+    // IORING_OP_TIMEOUT 要求 timespec 在完成前保持有效
+    __kernel_timespec ts_{};
     friend class IOContext;
     friend class Scheduler;
 };
@@ -217,10 +508,6 @@ inline auto accept(int sockfd, sockaddr* addr, socklen_t* addrlen) noexcept
     return AcceptAwaiter(sockfd, addr, addrlen);
 }
 inline auto read(int fd, void* buf, size_t nbytes) noexcept { return ReadAwaiter(fd, buf, nbytes); }
-inline auto read(std::string_view file_name, void* buf, size_t nbytes)
-{
-    return FileReadAwaiter(file_name, buf, nbytes);
-}
 inline auto write(int fd, const void* buf, size_t nbytes) noexcept { return WriteAwaiter(fd, buf, nbytes); }
 
 inline auto recv(int fd, void* buf, size_t nbytes, int flags) noexcept { return RecvAwaiter(fd, buf, nbytes, flags); }
@@ -229,5 +516,31 @@ inline auto send(int fd, const void* buf, size_t nbytes, int flags) noexcept
 {
     return SendAwaiter(fd, buf, nbytes, flags);
 }
-inline auto delay(int timeout_ms) noexcept { return DelayAwaiter(timeout_ms); }
+inline auto readv(int fd, const iovec* iov, size_t iovcnt) noexcept { return ReadvAwaiter(fd, iov, iovcnt); }
+inline auto writev(int fd, iovec* iov, size_t iovcnt) noexcept { return WritevAwaiter(fd, iov, iovcnt); }
+inline auto recvmsg(int fd, msghdr* msg, int flags) noexcept { return RecvmsgAwaiter(fd, msg, flags); }
+inline auto sendmsg(int fd, msghdr* msg, int flags) noexcept { return SendmsgAwaiter(fd, msg, flags); }
+inline auto poll(int fd, short events) noexcept { return PollAwaiter(fd, events); }
+inline auto read_at(int fd, void* buf, size_t nbytes, uint64_t offset) noexcept
+{
+    return ReadAtAwaiter(fd, buf, nbytes, offset);
+}
+inline auto write_at(int fd, const void* buf, size_t nbytes, uint64_t offset) noexcept
+{
+    return WriteAtAwaiter(fd, buf, nbytes, offset);
+}
+// prep 只负责 io_uring_prep_*，不要修改 user_data，例如：
+// co_await uring_op([fd](io_uring_sqe* sqe) { io_uring_prep_poll_add(sqe, fd, POLLIN); });
+template <typename F>
+    requires std::invocable<F&, io_uring_sqe*>
+inline auto uring_op(F prep)
+{
+    return UringOpAwaiter<F>(std::move(prep));
+}
+// 单位为秒，与 DelayAwaiter(double) 一致；更细的粒度用 chrono 重载
+inline auto delay(int timeout) noexcept { return DelayAwaiter(static_cast<double>(timeout)); }
+template <typename Rep, typename Period> inline auto delay(std::chrono::duration<Rep, Period> timeout) noexcept
+{
+    return DelayAwaiter(std::chrono::duration_cast<std::chrono::nanoseconds>(timeout));
+}
 } // namespace utils
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "coroutine/coroutine.h"
 #include "coroutine/cospawn.h"
+#include "coroutine/iostats.h"
 #include "coroutine/syscall.h"
 #include "schedule.h"
 #include "scheduler.h"
@@ -18,6 +19,26 @@ void co_spawn(Promise* call, bool yield)
 
 void schedule() { instance().schedule(); }
 
+void co_spawn_pinned(Promise* call, int home) { instance().co_spawn_pinned(call, home); }
+
+int pick_processor(PinPolicy policy) { return instance().pick_processor(policy); }
+
+void release_pin(int home) { instance().release_pin(home); }
+
+int current_processor() { return instance().current_processor(); }
+
+size_t processor_count() { return Scheduler::max_procs; }
+
+auto io_backend() -> IoBackend { return instance().io_backend(); }
+
+void set_submit_policy(SubmitPolicy policy) { IOContext::set_submit_policy(policy); }
+
+void set_spin_policy(SpinPolicy policy) { IOContext::set_spin_policy(policy); }
+
+auto submit_stats() -> std::vector<SubmitStats> { return instance().submit_stats(); }
+
+auto poll_stats() -> std::vector<PollStats> { return instance().poll_stats(); }
+
 template <typename T> bool process(T* awaiter) { return instance().get_io_context().process(awaiter); }
 
 template bool process(ConnectAwaiter* awaiter);
@@ -27,5 +48,17 @@ template bool process(ReadAwaiter* awaiter);
 template bool process(WriteAwaiter* awaiter);
 template bool process(RecvAwaiter* awaiter);
 template bool process(SendAwaiter* awaiter);
+template bool process(ReadvAwaiter* awaiter);
+template bool process(WritevAwaiter* awaiter);
+template bool process(RecvmsgAwaiter* awaiter);
+template bool process(SendmsgAwaiter* awaiter);
+template bool process(OpenAtAwaiter* awaiter);
+template bool process(StatxAwaiter* awaiter);
+template bool process(ReadAtAwaiter* awaiter);
+template bool process(WriteAtAwaiter* awaiter);
+template bool process(FsyncAwaiter* awaiter);
+template bool process(CloseAwaiter* awaiter);
+template bool process(PollAwaiter* awaiter);
+template bool process(UringOpAwaiterBase* awaiter);
 
 } // namespace utils
\ No newline at end of file
@@ -2,22 +2,35 @@
 
 #include "coroutine/coroutine.h"
 #include "coroutine/intrusivelist.h"
+#include "coroutine/iostats.h"
+#include "coroutine/spinlock.h"
 #include "coroutine/syscall.h"
 #include "timewheel.h"
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <bit>
 #include <cassert>
+#include <chrono>
 #include <cerrno>
 #include <coroutine>
 #include <cstddef>
+#include <cstdlib>
 #include <ctime>
 #include <functional>
+#include <immintrin.h>
 #include <iostream>
 #include <liburing.h>
 #include <mutex>
 #include <queue>
+#include <sys/epoll.h>
 #include <sys/eventfd.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
 #include <sys/timerfd.h>
+#include <string_view>
+#include <unistd.h>
+#include <unordered_map>
 #include <vector>
 namespace utils
 {
@@ -28,25 +41,51 @@ class IOContext
 {
   public:
     IOContext();
-    ~IOContext() { io_uring_queue_exit(&ring_); }
+    ~IOContext()
+    {
+        if (backend_ == IoBackend::URING)
+        {
+            io_uring_queue_exit(&ring_);
+        }
+        else
+        {
+            ::close(epfd_);
+        }
+    }
+    auto backend() const -> IoBackend { return backend_; }
     auto has_work() -> bool
     {
         // 包含eventfd的IO操作
-        return event_count_ > 1;
+        return event_count_ > 1 || !ready_.empty();
     }
-    auto poll(bool block) -> IntrusiveList
+    // max_wait_ms >= 0 时阻塞等待不超过该时长
+    auto poll(bool block, int max_wait_ms = -1) -> IntrusiveList
     {
+        if (backend_ == IoBackend::EPOLL)
+        {
+            return epoll_poll(block, max_wait_ms);
+        }
+        // 归还被其他 P 收割走的完成事件
+        if (harvested_.load(std::memory_order_relaxed) > 0)
+        {
+            event_count_ -= harvested_.exchange(0, std::memory_order_acquire);
+        }
         assert(event_count_ > 0);
-        // 提交所有未提交的IO操作，降低延迟
-        if (unsubmitted_count_ > 0)
+        // 完成事件可能全被其他 P 收割走了，阻塞之前先把空出来的位置让给 pending 的请求，
+        // 否则可能等一个永远不会到来的 CQE
+        submit_pending();
+        if (!block)
         {
-            auto ret = io_uring_submit(&ring_);
-            assert(ret == unsubmitted_count_);
-            unsubmitted_count_ = 0;
+            // 提交所有未提交的IO操作，降低延迟
+            flush();
         }
-        if (block)
+        else
         {
             int next_timeout_ms = timer_wheel_.get_next_timeout();
+            if (max_wait_ms >= 0 && (next_timeout_ms < 0 || next_timeout_ms > max_wait_ms))
+            {
+                next_timeout_ms = max_wait_ms;
+            }
             struct __kernel_timespec ts;
             struct __kernel_timespec* ts_ptr = nullptr;
             if (next_timeout_ms >= 0)
@@ -61,11 +100,18 @@ class IOContext
                 ts_ptr = &ts;
             }
             struct io_uring_cqe* cqe = nullptr;
+            blocking_waits_.fetch_add(1, std::memory_order_relaxed);
+            // 提交与等待合并为一次 io_uring_enter
+            auto submitted = unsubmitted_count_;
+            unsubmitted_count_ = 0;
             int ret = -EINTR;
             while (ret == -EINTR)
             {
-                ret = io_uring_wait_cqe_timeout(&ring_, &cqe, ts_ptr);
-                // ret = io_uring_submit_and_wait(&ring_, 1);
+                ret = io_uring_submit_and_wait_timeout(&ring_, &cqe, 1, ts_ptr, nullptr);
+            }
+            if (submitted > 0)
+            {
+                record_submit(submitted);
             }
         }
 
@@ -73,6 +119,9 @@ class IOContext
         int finished_count = 0;
         unsigned head;
         struct io_uring_cqe* cqe;
+        // CQ 可能同时被其他 P 收割
+        std::unique_lock<SpinLock> cq_lock(cq_lock_);
+        last_reap_.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
         // 批量遍历所有完成事件
         io_uring_for_each_cqe(&ring_, head, cqe)
         {
@@ -95,14 +144,10 @@ class IOContext
         if (finished_count)
         {
             io_uring_cq_advance(&ring_, finished_count);
-            event_count_ -= finished_count;
-            // 处理pending的函数
-            while (event_count_ < entries && !pending_call_.empty())
-            {
-                auto awaiter = pending_call_.pop_front();
-                process_impl(static_cast<SysAwaiterBase*>(awaiter));
-            }
         }
+        cq_lock.unlock();
+        event_count_ -= finished_count;
+        submit_pending();
         auto ready = timer_wheel_.update();
         for (auto timer : ready)
         {
@@ -112,6 +157,150 @@ class IOContext
         }
         return coroutines;
     }
+    // 距上次收割 CQ 超过 stall，说明拥有者正忙于运行协程
+    bool stalled(Clock::duration stall) const
+    {
+        return Clock::now().time_since_epoch().count() - last_reap_.load(std::memory_order_relaxed) > stall.count();
+    }
+    // 由其他 P 调用：拥有者长时间未收割时代为收割已完成的 IO，返回就绪的协程
+    // 只动 CQ，不碰 SQ、时间轮和 pending 队列；遇到 eventfd 事件就停下，留给拥有者重新注册
+    // 完成回调中的续写会提交到调用方自己的 ring 上
+    auto harvest(Clock::duration stall) -> IntrusiveList
+    {
+        IntrusiveList coroutines;
+        // epoll 后端的就绪事件只能由拥有者处理
+        if (backend_ == IoBackend::EPOLL || io_uring_cq_ready(&ring_) == 0 || !stalled(stall))
+        {
+            return coroutines;
+        }
+        std::unique_lock<SpinLock> cq_lock(cq_lock_, std::try_to_lock);
+        if (!cq_lock.owns_lock())
+        {
+            return coroutines;
+        }
+        int finished_count = 0;
+        unsigned head;
+        struct io_uring_cqe* cqe;
+        io_uring_for_each_cqe(&ring_, head, cqe)
+        {
+            auto awaiter = reinterpret_cast<SysAwaiterBase*>(cqe->user_data);
+            if (awaiter == &eventfd_awaiter_)
+            {
+                break;
+            }
+            if (auto handle = awaiter->set_value(cqe->res); handle)
+            {
+                coroutines.push_back(handle);
+            }
+            ++finished_count;
+        }
+        if (finished_count)
+        {
+            io_uring_cq_advance(&ring_, finished_count);
+            harvested_.fetch_add(finished_count, std::memory_order_release);
+            harvested_total_.fetch_add(finished_count, std::memory_order_relaxed);
+        }
+        return coroutines;
+    }
+    // 处理因 SQ 容量不足而排队的请求
+    void submit_pending()
+    {
+        while (event_count_ < entries && !pending_call_.empty())
+        {
+            auto awaiter = pending_call_.pop_front();
+            process_impl(static_cast<SysAwaiterBase*>(awaiter));
+        }
+    }
+    // 提交所有未提交的 SQE
+    void flush()
+    {
+        if (unsubmitted_count_ == 0)
+        {
+            return;
+        }
+        auto ret = io_uring_submit(&ring_);
+        assert(ret == unsubmitted_count_);
+        record_submit(unsubmitted_count_);
+        unsubmitted_count_ = 0;
+    }
+    // 最早的未提交 SQE 超出时间预算则提交，运行队列繁忙时由调度器在协程之间调用
+    void flush_if_due()
+    {
+        if (unsubmitted_count_ > 0 &&
+            Clock::now() - first_unsubmitted_time_ >= max_delay_.load(std::memory_order_relaxed))
+        {
+            flush();
+        }
+    }
+    // 阻塞前在用户态忙轮询 CQ（不进入内核），返回窗口内是否出现完成事件
+    // 命中时窗口放大到观测等待时间的两倍，超时则减半
+    bool spin_poll()
+    {
+        auto max_spin = std::chrono::nanoseconds(max_spin_.load(std::memory_order_relaxed));
+        if (max_spin.count() == 0 || backend_ == IoBackend::EPOLL)
+        {
+            return false;
+        }
+        auto spin_window = spin_window_.load(std::memory_order_relaxed);
+        auto window = adaptive_spin_.load(std::memory_order_relaxed) ? std::min(spin_window, max_spin) : max_spin;
+        flush();
+        auto start = Clock::now();
+        auto deadline = start + window;
+        // 不越过最近的定时器，到期由 poll 处理
+        if (auto next_timeout_ms = timer_wheel_.get_next_timeout(); next_timeout_ms >= 0)
+        {
+            deadline = std::min(deadline, start + MS(next_timeout_ms));
+        }
+        while (true)
+        {
+            if (io_uring_cq_ready(&ring_) > 0)
+            {
+                std::chrono::nanoseconds waited = Clock::now() - start;
+                spin_window_.store(std::min(std::max(spin_window, 2 * waited), max_spin), std::memory_order_relaxed);
+                spin_hits_.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+            if (Clock::now() >= deadline)
+            {
+                break;
+            }
+            _mm_pause();
+        }
+        spin_window_.store(std::max(spin_window / 2, min_spin_window), std::memory_order_relaxed);
+        spin_misses_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    static void set_spin_policy(SpinPolicy policy)
+    {
+        max_spin_.store(std::chrono::nanoseconds(policy.max_spin).count(), std::memory_order_relaxed);
+        adaptive_spin_.store(policy.adaptive, std::memory_order_relaxed);
+    }
+    auto poll_stats() const -> PollStats
+    {
+        PollStats stats;
+        stats.spin_hits = spin_hits_.load(std::memory_order_relaxed);
+        stats.spin_misses = spin_misses_.load(std::memory_order_relaxed);
+        stats.blocking_waits = blocking_waits_.load(std::memory_order_relaxed);
+        stats.spin_window = spin_window_.load(std::memory_order_relaxed);
+        stats.harvested_cqes = harvested_total_.load(std::memory_order_relaxed);
+        return stats;
+    }
+    static void set_submit_policy(SubmitPolicy policy)
+    {
+        max_batch_.store(std::max<size_t>(policy.max_batch, 1), std::memory_order_relaxed);
+        max_delay_.store(policy.max_delay, std::memory_order_relaxed);
+    }
+    auto submit_stats() const -> SubmitStats
+    {
+        SubmitStats stats;
+        stats.submit_calls = submit_calls_.load(std::memory_order_relaxed);
+        stats.submitted_sqes = submitted_sqes_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < stats.batch_histogram.size(); ++i)
+        {
+            stats.batch_histogram[i] = batch_histogram_[i].load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
     void reset_eventfd();
     void wake()
     {
@@ -129,26 +318,118 @@ class IOContext
     template <typename Awaiter>
     bool process_impl(Awaiter* awaiter)
         requires(std::is_base_of_v<SysAwaiterBase, Awaiter>);
-    constexpr static size_t submit_interval = 64;
+    // 启动时选择后端：环境变量 COROUTINE_IO_BACKEND=epoll|uring，io_uring 不可用时回退到 epoll
+    static auto preferred_backend() -> IoBackend;
+    // === epoll 后端 ===
+    // 立即尝试非阻塞系统调用，EAGAIN 时挂到 fd 上等待就绪后重试
+    template <typename Awaiter> void epoll_process(Awaiter* awaiter);
+    template <typename Awaiter> auto epoll_try(Awaiter* awaiter) -> int;
+    void epoll_park(int fd, uint32_t events, SysAwaiterBase* awaiter);
+    auto epoll_poll(bool block, int max_wait_ms) -> IntrusiveList;
+    // 完成的协程先放入 ready_，由下一次 poll 返回
+    void epoll_complete(SysAwaiterBase* awaiter, int result)
+    {
+        if (auto handle = awaiter->set_value(result); handle)
+        {
+            ready_.push_back(handle);
+        }
+    }
+    void record_submit(size_t count)
+    {
+        submit_calls_.fetch_add(1, std::memory_order_relaxed);
+        submitted_sqes_.fetch_add(count, std::memory_order_relaxed);
+        auto bucket = std::min<size_t>(std::bit_width(count) - 1, batch_histogram_.size() - 1);
+        batch_histogram_[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
     constexpr static size_t entries = 1024;
+    constexpr static size_t max_epoll_events = 256;
+    // 时间轮精度，更短的延时由 io_uring 超时处理
+    constexpr static MS timer_tick{1};
+    IoBackend backend_{preferred_backend()};
     io_uring ring_;
+    int epfd_{-1};
+    // epoll 后端：每个 fd 上等待读/写就绪的请求
+    struct FdWaiters
+    {
+        IntrusiveList readers{};
+        IntrusiveList writers{};
+    };
+    std::unordered_map<int, FdWaiters> fd_waiters_;
+    IntrusiveList ready_{};
+    static inline std::atomic<IoBackend> fallback_backend_{IoBackend::URING};
     int eventfd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
     // eventfd_ read 的缓冲区
 
     uint64_t eventfd_buf_ = 0;
     ReadAwaiter eventfd_awaiter_{eventfd_, &eventfd_buf_, 8};
 
-    BitwiseTimerWheel timer_wheel_{MS(1), std::vector<size_t>{8, 6, 6, 6, 6}};
+    BitwiseTimerWheel timer_wheel_{timer_tick, std::vector<size_t>{8, 6, 6, 6, 6}};
     IntrusiveList pending_call_{};
     size_t event_count_ = 0;
     size_t unsubmitted_count_ = 0;
+    // 第一个未提交 SQE 的入队时间
+    Clock::time_point first_unsubmitted_time_{};
+    // 提交策略，所有 P 共享
+    static inline std::atomic<size_t> max_batch_{SubmitPolicy{}.max_batch};
+    static inline std::atomic<std::chrono::microseconds> max_delay_{SubmitPolicy{}.max_delay};
+    // 提交统计，可能被其他线程读取
+    std::atomic<uint64_t> submit_calls_{0};
+    std::atomic<uint64_t> submitted_sqes_{0};
+    std::array<std::atomic<uint64_t>, SubmitStats{}.batch_histogram.size()> batch_histogram_{};
+    // 忙轮询策略，所有 P 共享
+    static inline std::atomic<int64_t> max_spin_{std::chrono::nanoseconds(SpinPolicy{}.max_spin).count()};
+    static inline std::atomic<bool> adaptive_spin_{SpinPolicy{}.adaptive};
+    // 窗口下限，避免连续超时后衰减到 0 再也学不回来
+    constexpr static std::chrono::nanoseconds min_spin_window{1000};
+    // 仅本 P 线程修改，统计时可能被其他线程读取
+    std::atomic<std::chrono::nanoseconds> spin_window_{SpinPolicy{}.max_spin};
+    std::atomic<uint64_t> spin_hits_{0};
+    std::atomic<uint64_t> spin_misses_{0};
+    std::atomic<uint64_t> blocking_waits_{0};
+    // 保护 CQ 消费端，拥有者与收割者互斥
+    SpinLock cq_lock_{};
+    // 上次拥有者收割 CQ 的时间（steady_clock 计数）
+    std::atomic<Clock::rep> last_reap_{Clock::now().time_since_epoch().count()};
+    // 被其他 P 收割、尚未从 event_count_ 扣除的完成数
+    std::atomic<size_t> harvested_{0};
+    std::atomic<uint64_t> harvested_total_{0};
     friend class Scheduler;
 };
 
+inline auto IOContext::preferred_backend() -> IoBackend
+{
+    static const IoBackend configured = [] {
+        auto env = std::getenv("COROUTINE_IO_BACKEND");
+        return env && std::string_view(env) == "epoll" ? IoBackend::EPOLL : IoBackend::URING;
+    }();
+    return configured == IoBackend::EPOLL ? IoBackend::EPOLL : fallback_backend_.load();
+}
+
 inline IOContext::IOContext()
 {
-    auto res = io_uring_queue_init(entries, &ring_, 0);
-    assert(res >= 0);
+    if (backend_ == IoBackend::URING)
+    {
+        if (auto res = io_uring_queue_init(entries, &ring_, 0); res < 0)
+        {
+            // 例如被 seccomp 禁用，之后创建的 IOContext 直接使用 epoll
+            std::cerr << "io_uring unavailable (" << -res << "), falling back to epoll" << std::endl;
+            fallback_backend_.store(IoBackend::EPOLL);
+            backend_ = IoBackend::EPOLL;
+        }
+    }
+    if (backend_ == IoBackend::EPOLL)
+    {
+        epfd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        assert(epfd_ >= 0);
+        epoll_event ev{};
+        ev.events = EPOLLIN;
+        ev.data.fd = eventfd_;
+        auto res = ::epoll_ctl(epfd_, EPOLL_CTL_ADD, eventfd_, &ev);
+        assert(res == 0);
+        // 与 io_uring 后端一致，eventfd 计作一个常驻事件
+        event_count_ = 1;
+        return;
+    }
     eventfd_awaiter_.fd_ = eventfd_;
     eventfd_awaiter_.buf_ = &eventfd_buf_;
     eventfd_awaiter_.nbytes_ = sizeof(eventfd_buf_);
@@ -162,11 +443,21 @@ bool IOContext::process(Awaiter* awaiter)
 {
     if constexpr (std::is_same_v<DelayAwaiter, Awaiter>)
     {
-        awaiter = static_cast<DelayAwaiter*>(awaiter);
-        timer_wheel_.add_timer(MS(size_t(awaiter->timeout_ * 1000)), awaiter);
-        return true;
+        // 低于时间轮精度的延时走 IORING_OP_TIMEOUT
+        if (awaiter->timeout_ >= timer_tick)
+        {
+            timer_wheel_.add_timer(std::chrono::ceil<MS>(awaiter->timeout_), awaiter);
+            return true;
+        }
+        // epoll 后端没有高精度超时，交给时间轮，按一个刻度等待
+        if (backend_ == IoBackend::EPOLL)
+        {
+            timer_wheel_.add_timer(timer_tick, awaiter);
+            return true;
+        }
     }
-    if (event_count_ >= entries)
+    // epoll 后端没有 SQ 容量限制
+    if (backend_ == IoBackend::URING && event_count_ >= entries)
     {
         pending_call_.push_back(awaiter);
         return true;
@@ -207,11 +498,70 @@ bool IOContext::process_impl(Awaiter* awaiter)
             process_impl(static_cast<SendAwaiter*>(awaiter));
             break;
         }
+        case SysCallType::DELAY: {
+            process_impl(static_cast<DelayAwaiter*>(awaiter));
+            break;
+        }
+        case SysCallType::READV: {
+            process_impl(static_cast<ReadvAwaiter*>(awaiter));
+            break;
+        }
+        case SysCallType::WRITEV: {
+            process_impl(static_cast<WritevAwaiter*>(awaiter));
+            break;
+        }
+        case SysCallType::RECVMSG: {
+            process_impl(static_cast<RecvmsgAwaiter*>(awaiter));
+            break;
+        }
+        case SysCallType::SENDMSG: {
+            process_impl(static_cast<SendmsgAwaiter*>(awaiter));
+            break;
+        }
+        case SysCallType::OPENAT: {
+            process_impl(static_cast<OpenAtAwaiter*>(awaiter));
+            break;
+        }
+        case SysCallType::STATX: {
+            process_impl(static_cast<StatxAwaiter*>(awaiter));
+            break;
+        }
+        case SysCallType::READ_AT: {
+            process_impl(static_cast<ReadAtAwaiter*>(awaiter));
+            break;
+        }
+        case SysCallType::WRITE_AT: {
+            process_impl(static_cast<WriteAtAwaiter*>(awaiter));
+            break;
+        }
+        case SysCallType::FSYNC: {
+            process_impl(static_cast<FsyncAwaiter*>(awaiter));
+            break;
+        }
+        case SysCallType::CLOSE: {
+            process_impl(static_cast<CloseAwaiter*>(awaiter));
+            break;
+        }
+        case SysCallType::POLL: {
+            process_impl(static_cast<PollAwaiter*>(awaiter));
+            break;
+        }
+        case SysCallType::URING_OP: {
+            process_impl(static_cast<UringOpAwaiterBase*>(awaiter));
+            break;
+        }
         default: {
             assert(false);
             break;
         }
         }
+        // 已由具体类型处理，不能再为基类申请 SQE
+        return true;
+    }
+    else if (backend_ == IoBackend::EPOLL)
+    {
+        epoll_process(awaiter);
+        return true;
     }
 
     auto sqe = io_uring_get_sqe(&ring_);
@@ -261,17 +611,329 @@ bool IOContext::process_impl(Awaiter* awaiter)
         auto send_awaiter = static_cast<SendAwaiter*>(awaiter);
         io_uring_prep_send(sqe, send_awaiter->fd_, send_awaiter->buf_, send_awaiter->nbytes_, send_awaiter->flags_);
     }
+    else if constexpr (std::is_same_v<ReadvAwaiter, Awaiter>)
+    {
+        auto readv_awaiter = static_cast<ReadvAwaiter*>(awaiter);
+        io_uring_prep_readv(sqe, readv_awaiter->fd_, readv_awaiter->iov_, readv_awaiter->iovcnt_, 0);
+    }
+    else if constexpr (std::is_same_v<WritevAwaiter, Awaiter>)
+    {
+        auto writev_awaiter = static_cast<WritevAwaiter*>(awaiter);
+        io_uring_prep_writev(sqe, writev_awaiter->fd_, writev_awaiter->iov_, writev_awaiter->iovcnt_, 0);
+    }
+    else if constexpr (std::is_same_v<RecvmsgAwaiter, Awaiter>)
+    {
+        auto recvmsg_awaiter = static_cast<RecvmsgAwaiter*>(awaiter);
+        io_uring_prep_recvmsg(sqe, recvmsg_awaiter->fd_, recvmsg_awaiter->msg_, recvmsg_awaiter->flags_);
+    }
+    else if constexpr (std::is_same_v<SendmsgAwaiter, Awaiter>)
+    {
+        auto sendmsg_awaiter = static_cast<SendmsgAwaiter*>(awaiter);
+        io_uring_prep_sendmsg(sqe, sendmsg_awaiter->fd_, sendmsg_awaiter->msg_, sendmsg_awaiter->flags_);
+    }
+    else if constexpr (std::is_same_v<OpenAtAwaiter, Awaiter>)
+    {
+        auto open_awaiter = static_cast<OpenAtAwaiter*>(awaiter);
+        io_uring_prep_openat2(sqe, open_awaiter->dirfd_, open_awaiter->path_.c_str(), &open_awaiter->how_);
+    }
+    else if constexpr (std::is_same_v<StatxAwaiter, Awaiter>)
+    {
+        auto statx_awaiter = static_cast<StatxAwaiter*>(awaiter);
+        io_uring_prep_statx(sqe, statx_awaiter->dirfd_, statx_awaiter->path_.c_str(), statx_awaiter->flags_,
+                            statx_awaiter->mask_, statx_awaiter->buf_);
+    }
+    else if constexpr (std::is_same_v<ReadAtAwaiter, Awaiter>)
+    {
+        auto read_awaiter = static_cast<ReadAtAwaiter*>(awaiter);
+        io_uring_prep_read(sqe, read_awaiter->fd_, read_awaiter->buf_, read_awaiter->nbytes_, read_awaiter->offset_);
+    }
+    else if constexpr (std::is_same_v<WriteAtAwaiter, Awaiter>)
+    {
+        auto write_awaiter = static_cast<WriteAtAwaiter*>(awaiter);
+        io_uring_prep_write(sqe, write_awaiter->fd_, write_awaiter->buf_, write_awaiter->nbytes_,
+                            write_awaiter->offset_);
+    }
+    else if constexpr (std::is_same_v<FsyncAwaiter, Awaiter>)
+    {
+        auto fsync_awaiter = static_cast<FsyncAwaiter*>(awaiter);
+        io_uring_prep_fsync(sqe, fsync_awaiter->fd_, fsync_awaiter->datasync_ ? IORING_FSYNC_DATASYNC : 0);
+    }
+    else if constexpr (std::is_same_v<CloseAwaiter, Awaiter>)
+    {
+        auto close_awaiter = static_cast<CloseAwaiter*>(awaiter);
+        io_uring_prep_close(sqe, close_awaiter->fd_);
+    }
+    else if constexpr (std::is_same_v<PollAwaiter, Awaiter>)
+    {
+        auto poll_awaiter = static_cast<PollAwaiter*>(awaiter);
+        io_uring_prep_poll_add(sqe, poll_awaiter->fd_, poll_awaiter->events_);
+    }
+    else if constexpr (std::is_same_v<UringOpAwaiterBase, Awaiter>)
+    {
+        auto op_awaiter = static_cast<UringOpAwaiterBase*>(awaiter);
+        op_awaiter->prep_(op_awaiter, sqe);
+    }
+    else if constexpr (std::is_same_v<DelayAwaiter, Awaiter>)
+    {
+        auto delay_awaiter = static_cast<DelayAwaiter*>(awaiter);
+        auto ns = std::max<int64_t>(delay_awaiter->timeout_.count(), 0);
+        delay_awaiter->ts_.tv_sec = ns / 1000000000LL;
+        delay_awaiter->ts_.tv_nsec = ns % 1000000000LL;
+        io_uring_prep_timeout(sqe, &delay_awaiter->ts_, 0, 0);
+    }
 
     // 先设置请求在设置user_data
     sqe->user_data = reinterpret_cast<uintptr_t>(awaiter);
     ++event_count_;
-    if (++unsubmitted_count_ >= submit_interval)
+    if (unsubmitted_count_++ == 0)
     {
-        auto ret = io_uring_submit(&ring_);
-        assert(ret == unsubmitted_count_);
-        unsubmitted_count_ = 0;
+        first_unsubmitted_time_ = Clock::now();
+    }
+    // 批次的第一个 SQE 也要检查数量，max_batch = 1 时立即提交
+    if (unsubmitted_count_ >= max_batch_.load(std::memory_order_relaxed))
+    {
+        flush();
+    }
+    else
+    {
+        flush_if_due();
     }
     return true;
 }
 
+template <typename Awaiter> void IOContext::epoll_process(Awaiter* awaiter)
+{
+    constexpr uint32_t events = [] {
+        if constexpr (std::is_same_v<AcceptAwaiter, Awaiter> || std::is_same_v<ReadAwaiter, Awaiter> ||
+                      std::is_same_v<RecvAwaiter, Awaiter> || std::is_same_v<ReadvAwaiter, Awaiter> ||
+                      std::is_same_v<RecvmsgAwaiter, Awaiter>)
+        {
+            return static_cast<uint32_t>(EPOLLIN);
+        }
+        else if constexpr (std::is_same_v<ConnectAwaiter, Awaiter> || std::is_same_v<WriteAwaiter, Awaiter> ||
+                           std::is_same_v<SendAwaiter, Awaiter> || std::is_same_v<WritevAwaiter, Awaiter> ||
+                           std::is_same_v<SendmsgAwaiter, Awaiter>)
+        {
+            return static_cast<uint32_t>(EPOLLOUT);
+        }
+        else
+        {
+            // 文件操作总是就绪，同步执行
+            return 0u;
+        }
+    }();
+    auto res = epoll_try(awaiter);
+    if constexpr (std::is_same_v<PollAwaiter, Awaiter>)
+    {
+        // 等待方向在运行时才知道；同时等待读写时只按可读挂起
+        if (res == -EAGAIN)
+        {
+            awaiter->parked_ = true;
+            epoll_park(awaiter->fd_, awaiter->events_ & POLLIN ? EPOLLIN : EPOLLOUT, awaiter);
+            return;
+        }
+    }
+    else if constexpr (events != 0)
+    {
+        if (res == -EAGAIN || res == -EWOULDBLOCK || res == -EINPROGRESS || res == -EALREADY)
+        {
+            if constexpr (std::is_same_v<AcceptAwaiter, Awaiter> || std::is_same_v<ConnectAwaiter, Awaiter>)
+            {
+                epoll_park(awaiter->sockfd_, events, awaiter);
+            }
+            else
+            {
+                epoll_park(awaiter->fd_, events, awaiter);
+            }
+            return;
+        }
+    }
+    epoll_complete(awaiter, res);
+}
+
+template <typename Awaiter> auto IOContext::epoll_try(Awaiter* awaiter) -> int
+{
+    // 与 io_uring 的 cqe->res 保持一致：失败返回 -errno
+    auto check = [](auto ret) -> int { return ret < 0 ? -errno : static_cast<int>(ret); };
+    if constexpr (std::is_same_v<AcceptAwaiter, Awaiter>)
+    {
+        return check(::accept4(awaiter->sockfd_, awaiter->addr_, awaiter->addrlen_, 0));
+    }
+    else if constexpr (std::is_same_v<ConnectAwaiter, Awaiter>)
+    {
+        // 重试时已连接的 socket 返回 EISCONN
+        if (::connect(awaiter->sockfd_, awaiter->addr_, awaiter->addrlen_) == 0 || errno == EISCONN)
+        {
+            return 0;
+        }
+        return -errno;
+    }
+    else if constexpr (std::is_same_v<ReadAwaiter, Awaiter>)
+    {
+        return check(::read(awaiter->fd_, awaiter->buf_, awaiter->nbytes_));
+    }
+    else if constexpr (std::is_same_v<WriteAwaiter, Awaiter>)
+    {
+        return check(::write(awaiter->fd_, awaiter->buf_, awaiter->nbytes_));
+    }
+    else if constexpr (std::is_same_v<RecvAwaiter, Awaiter>)
+    {
+        return check(::recv(awaiter->fd_, awaiter->buf_, awaiter->nbytes_, awaiter->flags_ | MSG_DONTWAIT));
+    }
+    else if constexpr (std::is_same_v<SendAwaiter, Awaiter>)
+    {
+        return check(::send(awaiter->fd_, awaiter->buf_, awaiter->nbytes_, awaiter->flags_ | MSG_DONTWAIT));
+    }
+    else if constexpr (std::is_same_v<ReadvAwaiter, Awaiter>)
+    {
+        return check(::readv(awaiter->fd_, awaiter->iov_, static_cast<int>(awaiter->iovcnt_)));
+    }
+    else if constexpr (std::is_same_v<WritevAwaiter, Awaiter>)
+    {
+        return check(::writev(awaiter->fd_, awaiter->iov_, static_cast<int>(awaiter->iovcnt_)));
+    }
+    else if constexpr (std::is_same_v<RecvmsgAwaiter, Awaiter>)
+    {
+        return check(::recvmsg(awaiter->fd_, awaiter->msg_, awaiter->flags_ | MSG_DONTWAIT));
+    }
+    else if constexpr (std::is_same_v<SendmsgAwaiter, Awaiter>)
+    {
+        return check(::sendmsg(awaiter->fd_, awaiter->msg_, awaiter->flags_ | MSG_DONTWAIT));
+    }
+    else if constexpr (std::is_same_v<OpenAtAwaiter, Awaiter>)
+    {
+        return check(::syscall(SYS_openat2, awaiter->dirfd_, awaiter->path_.c_str(), &awaiter->how_,
+                               sizeof(awaiter->how_)));
+    }
+    else if constexpr (std::is_same_v<StatxAwaiter, Awaiter>)
+    {
+        return check(
+            ::statx(awaiter->dirfd_, awaiter->path_.c_str(), awaiter->flags_, awaiter->mask_, awaiter->buf_));
+    }
+    else if constexpr (std::is_same_v<ReadAtAwaiter, Awaiter>)
+    {
+        return check(::pread(awaiter->fd_, awaiter->buf_, awaiter->nbytes_, awaiter->offset_));
+    }
+    else if constexpr (std::is_same_v<WriteAtAwaiter, Awaiter>)
+    {
+        return check(::pwrite(awaiter->fd_, awaiter->buf_, awaiter->nbytes_, awaiter->offset_));
+    }
+    else if constexpr (std::is_same_v<FsyncAwaiter, Awaiter>)
+    {
+        return check(awaiter->datasync_ ? ::fdatasync(awaiter->fd_) : ::fsync(awaiter->fd_));
+    }
+    else if constexpr (std::is_same_v<CloseAwaiter, Awaiter>)
+    {
+        return check(::close(awaiter->fd_));
+    }
+    else if constexpr (std::is_same_v<PollAwaiter, Awaiter>)
+    {
+        // 被事件唤醒：读队列只在可读、对端关闭或出错时重试，后续的读操作会拿到具体结果
+        if (awaiter->parked_)
+        {
+            return awaiter->events_ & POLLIN ? POLLIN : POLLOUT;
+        }
+        // 边沿触发下挂起前必须确认当前确实未就绪，否则已经到达的数据不会再产生事件
+        pollfd pfd{awaiter->fd_, awaiter->events_, 0};
+        auto ret = ::poll(&pfd, 1, 0);
+        if (ret < 0)
+        {
+            return -errno;
+        }
+        return ret == 0 ? -EAGAIN : pfd.revents;
+    }
+    else if constexpr (std::is_same_v<UringOpAwaiterBase, Awaiter>)
+    {
+        return -EOPNOTSUPP;
+    }
+    else
+    {
+        // 延时全部由时间轮处理
+        static_assert(std::is_same_v<DelayAwaiter, Awaiter>);
+        return 0;
+    }
+}
+
+inline void IOContext::epoll_park(int fd, uint32_t events, SysAwaiterBase* awaiter)
+{
+    auto [it, inserted] = fd_waiters_.try_emplace(fd);
+    if (inserted)
+    {
+        // 边沿触发，只在 EAGAIN 之后挂起，之后的新数据一定会产生新的边沿
+        // fd 没有等待者时会从表中删除，但内核里的注册可能还在，EEXIST 视为成功
+        epoll_event ev{};
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.fd = fd;
+        if (::epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev) < 0 && errno != EEXIST)
+        {
+            auto err = errno;
+            fd_waiters_.erase(it);
+            epoll_complete(awaiter, -err);
+            return;
+        }
+    }
+    (events & EPOLLIN ? it->second.readers : it->second.writers).push_back(awaiter);
+    ++event_count_;
+}
+
+inline auto IOContext::epoll_poll(bool block, int max_wait_ms) -> IntrusiveList
+{
+    int timeout_ms = 0;
+    if (block && ready_.empty())
+    {
+        timeout_ms = timer_wheel_.get_next_timeout();
+        if (max_wait_ms >= 0 && (timeout_ms < 0 || timeout_ms > max_wait_ms))
+        {
+            timeout_ms = max_wait_ms;
+        }
+        blocking_waits_.fetch_add(1, std::memory_order_relaxed);
+    }
+    std::array<epoll_event, max_epoll_events> events;
+    int n = ::epoll_wait(epfd_, events.data(), events.size(), timeout_ms);
+    last_reap_.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+    for (int i = 0; i < n; ++i)
+    {
+        int fd = events[i].data.fd;
+        if (fd == eventfd_)
+        {
+            // 只是唤醒
+            [[maybe_unused]] auto ret = ::read(eventfd_, &eventfd_buf_, sizeof(eventfd_buf_));
+            continue;
+        }
+        auto it = fd_waiters_.find(fd);
+        if (it == fd_waiters_.end())
+        {
+            continue;
+        }
+        IntrusiveList retry;
+        if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLERR | EPOLLHUP))
+        {
+            retry.push_back(std::move(it->second.readers));
+        }
+        if (events[i].events & (EPOLLOUT | EPOLLERR | EPOLLHUP))
+        {
+            retry.push_back(std::move(it->second.writers));
+        }
+        if (it->second.readers.empty() && it->second.writers.empty())
+        {
+            fd_waiters_.erase(it);
+        }
+        // 重试可能再次挂到同一个 fd 上
+        while (!retry.empty())
+        {
+            auto awaiter = static_cast<SysAwaiterBase*>(retry.pop_front());
+            --event_count_;
+            process_impl(awaiter);
+        }
+    }
+    auto ready = timer_wheel_.update();
+    for (auto timer : ready)
+    {
+        auto handle = static_cast<DelayAwaiter*>(timer)->set_value(0);
+        assert(handle);
+        ready_.push_back(handle);
+    }
+    return std::move(ready_);
+}
+
 } // namespace utils
\ No newline at end of file
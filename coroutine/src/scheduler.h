@@ -8,6 +8,7 @@
 #include <array>
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <coroutine>
 #include <cstddef>
 #include <cstdint>
@@ -93,6 +94,12 @@ class Processor
     std::atomic<Handle> run_next{};
     IOContext iocontext{};
     WorkStealingDeque coros;
+    // 其他 P 转交过来的固定协程
+    IntrusiveList inbox{};
+    SpinLock inbox_lock{};
+    std::atomic<bool> has_inbox{false};
+    // 以本 P 为 home 的存活固定协程数
+    std::atomic<int> pinned{0};
     int local_count_{0};
     // 是否自旋
     State state{State::SPINNING};
@@ -106,8 +113,33 @@ class Scheduler
     Scheduler();
     ~Scheduler() = default;
     void co_spawn(Handle coro, bool yield = false);
+    void co_spawn_pinned(Handle coro, int home);
+    int pick_processor(PinPolicy policy);
+    void release_pin(int home) { processors_[home]->pinned.fetch_sub(1, std::memory_order_relaxed); }
+    int current_processor() const { return current_processor_ ? static_cast<int>(current_processor_->id) : -1; }
     void schedule();
     auto get_io_context() -> IOContext&;
+    auto io_backend() const -> IoBackend { return processors_[0]->iocontext.backend(); }
+    auto submit_stats() const -> std::vector<SubmitStats>
+    {
+        std::vector<SubmitStats> stats;
+        stats.reserve(processors_.size());
+        for (const auto& p : processors_)
+        {
+            stats.push_back(p->iocontext.submit_stats());
+        }
+        return stats;
+    }
+    auto poll_stats() const -> std::vector<PollStats>
+    {
+        std::vector<PollStats> stats;
+        stats.reserve(processors_.size());
+        for (const auto& p : processors_)
+        {
+            stats.push_back(p->iocontext.poll_stats());
+        }
+        return stats;
+    }
     static auto& instance()
     {
         static Scheduler* scheduler = new Scheduler();
@@ -128,10 +160,16 @@ class Scheduler
     auto get_coro_from_processor(Processor* processor) -> Handle;
     auto get_coro_with_spinning(Processor* processor) -> Handle;
     auto steal_coroutine(Processor* p) -> Handle;
+    // 代为收割忙碌 P 的 CQ
+    auto harvest_completions(Processor* p) -> Handle;
+    // 固定协程不在 home 上时转交给 home，返回是否已转交
+    bool forward_to_home(Processor* p, Handle coro);
+    auto take_inbox(Processor* p) -> Handle;
 
     void wake_from_idle(Processor* p);
     void wake_from_polling(Processor* p);
     bool can_spinning();
+    void record_spin_result(bool hit);
     size_t get_idle_count();
     // 全部P
     const std::vector<std::unique_ptr<Processor>> processors_;
@@ -150,6 +188,11 @@ class Scheduler
     // 自旋P
     std::atomic<int> spinning_processors_count_{0};
     std::atomic<bool> make_spinning_{false};
+    // 自旋P上限：spin_ratio_ * 自旋数 <= 空闲数，根据自旋命中率自适应
+    std::atomic<size_t> spin_ratio_{3};
+    std::atomic<size_t> spin_hits_{0};
+    std::atomic<size_t> spin_rounds_{0};
+    std::atomic<size_t> next_home_{0};
 
     static auto create_processors(size_t n) -> std::vector<std::unique_ptr<Processor>>
     {
@@ -167,6 +210,15 @@ class Scheduler
 
     // 最大自旋回合
     static constexpr size_t max_spinning_epoch = 10;
+    static constexpr size_t spin_tune_interval = 64;
+    static constexpr size_t min_spin_ratio = 1;
+    static constexpr size_t max_spin_ratio = 8;
+    // home 的本地队列超过该长度视为过载，固定协程就地运行
+    static constexpr size_t pin_overload = WorkStealingDeque::Capacity / 2;
+    // P 的 CQ 超过该时长未被收割，空闲 P 可以代为收割
+    static constexpr auto harvest_stall = std::chrono::microseconds(100);
+    // 有其他 P 在运行时，阻塞等待的上限，保证 POLLING 的 P 也能定期收割
+    static constexpr int harvest_wait_ms = 1;
 };
 inline const size_t Scheduler::max_procs = std::thread::hardware_concurrency();
 
@@ -193,6 +245,10 @@ inline void Scheduler::schedule()
 inline void Scheduler::co_spawn(Handle coro, bool yield)
 {
     assert(coro);
+    if (forward_to_home(current_processor_, coro))
+    {
+        return;
+    }
     // 获取当前P
     if (!current_processor_)
     {
@@ -223,8 +279,15 @@ inline void Scheduler::processor_func(Processor* p)
     {
         auto coro = get_coro();
         assert(coro);
+        // 窃取或全局队列拿到的固定协程送回 home
+        if (forward_to_home(p, coro))
+        {
+            continue;
+        }
         p->local_count_++;
         coro->resume();
+        // 运行队列繁忙时不会走到 poll，按时间预算提交攒下的 SQE
+        p->iocontext.flush_if_due();
     }
 }
 
@@ -259,6 +322,7 @@ inline auto Scheduler::get_coro() -> Handle
         case Processor::State::SPINNING: {
             Handle coro = get_coro_with_spinning(processor);
             bool last_spinning = (spinning_processors_count_.fetch_sub(1) == 1);
+            record_spin_result(coro != nullptr);
             if (coro)
             {
                 processor->state = Processor::State::RUNNING;
@@ -288,8 +352,28 @@ inline auto Scheduler::get_coro() -> Handle
                 processor->state = Processor::State::SPINNING;
                 break;
             }
-            // 阻塞监听io
-            auto coros = processor->iocontext.poll(true);
+            // 与 forward_to_home 配对：先置 polling_mask_ 再检查 inbox，二者至少有一方能看到对方
+            if (processor->has_inbox.load())
+            {
+                polling_mask_.fetch_and(~(1ULL << processor->id));
+                processor->state = Processor::State::RUNNING;
+                running_mask_.fetch_or(1ULL << processor->id);
+                break;
+            }
+            // 睡眠前先帮忙碌的 P 收割完成事件
+            if (auto coro = harvest_completions(processor); coro)
+            {
+                polling_mask_.fetch_and(~(1ULL << processor->id));
+                processor->state = Processor::State::RUNNING;
+                running_mask_.fetch_or(1ULL << processor->id);
+                return coro;
+            }
+            // 先忙轮询 CQ，命中则无需进入内核睡眠
+            // 其他 P 在运行时限制睡眠时长，以便定期回来收割
+            bool others_running = running_mask_.load(std::memory_order::relaxed) & ~(1ULL << processor->id);
+            auto coros = processor->iocontext.spin_poll()
+                             ? processor->iocontext.poll(false)
+                             : processor->iocontext.poll(true, others_running ? harvest_wait_ms : -1);
             // 没有任务
             if (coros.empty())
             {
@@ -301,7 +385,6 @@ inline auto Scheduler::get_coro() -> Handle
                 }
                 break;
             }
-            // TODO:增加自旋
             //  获取到任务，优先执行
             auto coro = coros.pop_front();
             add_coro_to_processor(std::move(coros), processor);
@@ -316,7 +399,14 @@ inline auto Scheduler::get_coro() -> Handle
 }
 inline void Scheduler::make_spinning()
 {
-    make_spinning_.store(true);
+    // 调用方已为本次请求把自旋数加一，由取走 make_spinning_ 的 P 在自旋结束时减回
+    // 上一次请求还没有 P 取走时只会有一个 P 响应，这里撤销多加的计数，否则自旋数只增不减，
+    // can_spinning 永远失败，P 不看全局队列直接阻塞，co_spawn 也不再唤醒任何 P
+    if (make_spinning_.exchange(true))
+    {
+        spinning_processors_count_.fetch_sub(1);
+        return;
+    }
     if (auto mask = polling_mask_.load(std::memory_order::relaxed); mask)
     {
         auto low_1bit = mask & -mask;
@@ -387,10 +477,19 @@ inline auto Scheduler::get_coro_from_processor(Processor* processor) -> Handle
     {
         return coro;
     }
+    if (auto coro = take_inbox(processor); coro)
+    {
+        return coro;
+    }
     // 多次后，考虑从全局队列获取
     constexpr int interval = 61;
     if (processor->local_count_ % interval == 0)
     {
+        // 本地队列一直不空时也定期收割 CQ：IO 完成不会被饿住，stalled() 也只在 P 真正卡住时成立
+        if (processor->iocontext.has_work())
+        {
+            add_coro_to_processor(processor->iocontext.poll(false), processor);
+        }
         if (auto coros = get_global_coroutine(1); !coros.empty())
         {
             return static_cast<Handle>(coros.front());
@@ -428,7 +527,10 @@ inline auto Scheduler::get_coro_from_processor(Processor* processor) -> Handle
 inline auto Scheduler::get_coro_with_spinning(Processor* processor) -> Handle
 {
     bool more = false;
-    //
+    if (auto coro = take_inbox(processor); coro)
+    {
+        return coro;
+    }
     if (auto coros = get_global_coroutine(WorkStealingDeque::Capacity / 2); !coros.empty())
     {
         auto coro = static_cast<Handle>(coros.pop_front());
@@ -451,9 +553,125 @@ inline auto Scheduler::get_coro_with_spinning(Processor* processor) -> Handle
         }
         return static_cast<Handle>(coro);
     }
+    if (auto coro = harvest_completions(processor); coro)
+    {
+        return coro;
+    }
     return {};
 }
 
+inline auto Scheduler::harvest_completions(Processor* processor) -> Handle
+{
+    auto mask = running_mask_.load(std::memory_order::relaxed) & ~(1ULL << processor->id);
+    while (mask)
+    {
+        auto index = __builtin_ctzll(mask);
+        mask &= mask - 1;
+        if (auto coros = processors_[index]->iocontext.harvest(harvest_stall); !coros.empty())
+        {
+            auto coro = static_cast<Handle>(coros.pop_front());
+            bool need_spinning = !coros.empty();
+            add_coro_to_processor(std::move(coros), processor);
+            if (need_spinning)
+            {
+                spinning_processors_count_.fetch_add(1);
+                make_spinning();
+            }
+            return coro;
+        }
+    }
+    return {};
+}
+
+inline void Scheduler::co_spawn_pinned(Handle coro, int home)
+{
+    assert(coro);
+    if (home >= 0)
+    {
+        assert(static_cast<size_t>(home) < max_procs);
+        coro->pin(home);
+        processors_[home]->pinned.fetch_add(1, std::memory_order_relaxed);
+    }
+    co_spawn(coro);
+}
+
+inline int Scheduler::pick_processor(PinPolicy policy)
+{
+    switch (policy)
+    {
+    case PinPolicy::NONE:
+        return -1;
+    case PinPolicy::ROUND_ROBIN:
+        return next_home_.fetch_add(1, std::memory_order_relaxed) % max_procs;
+    case PinPolicy::LEAST_LOADED: {
+        size_t best = 0;
+        size_t best_load = SIZE_MAX;
+        for (size_t i = 0; i < max_procs; ++i)
+        {
+            auto& p = processors_[i];
+            size_t load = p->coros.size() + p->pinned.load(std::memory_order_relaxed);
+            if (load < best_load)
+            {
+                best = i;
+                best_load = load;
+            }
+        }
+        return best;
+    }
+    }
+    return -1;
+}
+
+inline bool Scheduler::forward_to_home(Processor* p, Handle coro)
+{
+    auto home = coro->home();
+    if (home < 0 || (p && static_cast<size_t>(home) == p->id))
+    {
+        return false;
+    }
+    auto target = processors_[home].get();
+    // 只按 home 本地队列的长度判断过载，过载时就地运行，home 不变，之后仍会回到 home
+    // 不看 CQ 多久没被收割：P 多于 CPU 时 home 线程被内核换下也会显得卡住，固定协程不能因此跑到别的 P 上
+    if (p && target->coros.size() >= pin_overload)
+    {
+        return false;
+    }
+    {
+        std::lock_guard<SpinLock> lock(target->inbox_lock);
+        target->inbox.push_back(coro);
+        target->has_inbox.store(true);
+    }
+    auto bit = 1ULL << home;
+    if (polling_mask_.load() & bit)
+    {
+        wake_from_polling(target);
+    }
+    else if (idle_mask_.load(std::memory_order::relaxed) & bit && idle_mask_.fetch_and(~bit) & bit)
+    {
+        // home 还没有启动过线程
+        spinning_processors_count_.fetch_add(1);
+        wake_from_idle(target);
+    }
+    return true;
+}
+
+inline auto Scheduler::take_inbox(Processor* p) -> Handle
+{
+    if (!p->has_inbox.load(std::memory_order::relaxed))
+    {
+        return {};
+    }
+    IntrusiveList coros;
+    {
+        std::lock_guard<SpinLock> lock(p->inbox_lock);
+        coros = std::move(p->inbox);
+        p->has_inbox.store(false, std::memory_order::relaxed);
+    }
+    auto coro = static_cast<Handle>(coros.pop_front());
+    add_coro_to_processor(std::move(coros), p);
+    return coro;
+}
+
 inline void Scheduler::add_global_coroutine(IntrusiveList coros)
 {
 
@@ -520,7 +738,8 @@ inline bool Scheduler::can_spinning()
         return true;
     }
     // 考虑自旋数
-    else if (auto count = spinning_processors_count_.load(std::memory_order::relaxed); 3 * count <= get_idle_count())
+    else if (auto count = spinning_processors_count_.load(std::memory_order::relaxed);
+             spin_ratio_.load(std::memory_order::relaxed) * count <= get_idle_count())
     {
         // 自旋
         spinning_processors_count_.fetch_add(1);
@@ -528,6 +747,29 @@ inline bool Scheduler::can_spinning()
     }
     return false;
 }
+inline void Scheduler::record_spin_result(bool hit)
+{
+    if (hit)
+    {
+        spin_hits_.fetch_add(1, std::memory_order::relaxed);
+    }
+    if (spin_rounds_.fetch_add(1, std::memory_order::relaxed) + 1 < spin_tune_interval)
+    {
+        return;
+    }
+    // 每 spin_tune_interval 轮按命中率调整一次：命中多则允许更多 P 自旋，命中少则收紧
+    spin_rounds_.store(0, std::memory_order::relaxed);
+    auto hits = spin_hits_.exchange(0, std::memory_order::relaxed);
+    auto ratio = spin_ratio_.load(std::memory_order::relaxed);
+    if (hits * 2 > spin_tune_interval && ratio > min_spin_ratio)
+    {
+        spin_ratio_.store(ratio - 1, std::memory_order::relaxed);
+    }
+    else if (hits * 8 < spin_tune_interval && ratio < max_spin_ratio)
+    {
+        spin_ratio_.store(ratio + 1, std::memory_order::relaxed);
+    }
+}
 inline size_t Scheduler::get_idle_count()
 {
     int running_count = __builtin_popcountll(running_mask_.load(std::memory_order::relaxed));
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <cstdint>
@@ -16,16 +17,23 @@ struct TimerTask
 
 struct WheelLevel
 {
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
     std::vector<std::list<TimerTask>> slots;
     std::vector<uint64_t> bitmap; // 核心：增加位图，每个 bit 对应一个槽位
+    // 每个槽位内最早的到期 tick，槽位为空时为 UINT64_MAX
+    std::vector<uint64_t> slot_min;
     uint64_t slot_mask;
     uint64_t shift;
     uint64_t total_range;
+    // 该层最早的到期 tick 缓存，min_dirty 为 true 时需要重新计算
+    uint64_t min_expire{UINT64_MAX};
+    bool min_dirty{false};
     WheelLevel(size_t bits, uint64_t accumulated_shift)
         : slots(1ULL << bits),
           // 如果槽位 < 64，只需要 1 个 uint64_t；如果是 256，需要 4 个 uint64_t
-          bitmap((1ULL << bits) > 64 ? (1ULL << (bits - 6)) : 1, 0), slot_mask((1ULL << bits) - 1),
-          shift(accumulated_shift), total_range(1ULL << (accumulated_shift + bits))
+          bitmap((1ULL << bits) > 64 ? (1ULL << (bits - 6)) : 1, 0), slot_min(1ULL << bits, UINT64_MAX),
+          slot_mask((1ULL << bits) - 1), shift(accumulated_shift), total_range(1ULL << (accumulated_shift + bits))
     {
     }
 
@@ -34,6 +42,89 @@ struct WheelLevel
 
     // 清除第 slot 个位（置为 0）
     inline void clear_bit(size_t slot) { bitmap[slot >> 6] &= ~(1ULL << (slot & 63)); }
+
+    void push(size_t slot, TimerTask task)
+    {
+        if (task.expire_tick < slot_min[slot])
+        {
+            slot_min[slot] = task.expire_tick;
+        }
+        if (task.expire_tick < min_expire)
+        {
+            min_expire = task.expire_tick;
+        }
+        slots[slot].push_back(std::move(task));
+        set_bit(slot);
+    }
+
+    // 取走整个槽位，同时维护位图和最小值缓存
+    std::list<TimerTask> take(size_t slot)
+    {
+        std::list<TimerTask> tasks;
+        tasks.splice(tasks.end(), slots[slot]);
+        clear_bit(slot);
+        // 被取走的槽位可能持有该层最小值，延迟到下次查询时重算
+        if (slot_min[slot] <= min_expire)
+        {
+            min_dirty = true;
+        }
+        slot_min[slot] = UINT64_MAX;
+        return tasks;
+    }
+
+    // 只遍历位图中的非空槽位，不遍历任务
+    uint64_t earliest()
+    {
+        if (min_dirty)
+        {
+            min_expire = UINT64_MAX;
+            for (size_t w = 0; w < bitmap.size(); ++w)
+            {
+                for (uint64_t word = bitmap[w]; word != 0; word &= word - 1)
+                {
+                    size_t slot = (w << 6) + __builtin_ctzll(word);
+                    if (slot_min[slot] < min_expire)
+                    {
+                        min_expire = slot_min[slot];
+                    }
+                }
+            }
+            min_dirty = false;
+        }
+        return min_expire;
+    }
+
+    // 在 [begin, end) 中查找第一个非空槽位
+    size_t find_first(size_t begin, size_t end) const
+    {
+        while (begin < end)
+        {
+            size_t w = begin >> 6;
+            uint64_t word = bitmap[w] & (~0ULL << (begin & 63));
+            if (word != 0)
+            {
+                size_t slot = (w << 6) + __builtin_ctzll(word);
+                return slot < end ? slot : npos;
+            }
+            begin = (w + 1) << 6;
+        }
+        return npos;
+    }
+
+    // 从 from 开始（含）环形查找第一个非空槽位，返回与 from 的距离
+    size_t distance_to_next(size_t from) const
+    {
+        size_t n = slots.size();
+        if (auto slot = find_first(from, n); slot != npos)
+        {
+            return slot - from;
+        }
+        if (auto slot = find_first(0, from); slot != npos)
+        {
+            return slot + n - from;
+        }
+        return npos;
+    }
 };
 
 class BitwiseTimerWheel
@@ -55,15 +146,28 @@ class BitwiseTimerWheel
         max_range = (accumulated_shift == 64) ? ~0ULL : (1ULL << accumulated_shift);
     }
 
-    std::vector<void*> update()
+    std::vector<void*> update() { return update(current_ms()); }
+
+    std::vector<void*> update(uint64_t now)
     {
         std::vector<void*> results;
-        uint64_t now = current_ms();
+        if (now <= last_tick_time)
+        {
+            return results;
+        }
         uint64_t ticks_to_process = (now - last_tick_time) / tick_interval_ms;
+        uint64_t target_tick = current_tick + ticks_to_process;
 
-        for (uint64_t i = 0; i < ticks_to_process; ++i)
+        while (current_tick < target_tick)
         {
-            current_tick++;
+            // 空闲跳跃：直接跳到下一个需要处理的 tick，中间的空 tick 不再逐个推进
+            uint64_t next = next_event_tick();
+            if (next > target_tick)
+            {
+                current_tick = target_tick;
+                break;
+            }
+            current_tick = next;
 
             size_t l0_slot = current_tick & levels[0].slot_mask;
 
@@ -76,13 +180,8 @@ class BitwiseTimerWheel
 
                     if (!levels[lvl].slots[slot].empty())
                     {
-                        std::list<TimerTask> tasks;
-                        tasks.splice(tasks.end(), levels[lvl].slots[slot]);
-
                         // 🌟 槽位被清空，立刻清除位图标志
-                        levels[lvl].clear_bit(slot);
-
-                        for (auto& task : tasks)
+                        for (auto& task : levels[lvl].take(slot))
                         {
                             insert_task(std::move(task));
                         }
@@ -96,14 +195,11 @@ class BitwiseTimerWheel
             // 执行底层到期任务
             if (!levels[0].slots[l0_slot].empty())
             {
-                for (auto& task : levels[0].slots[l0_slot])
+                // 🌟 底层任务执行完毕，清除位图标志
+                for (auto& task : levels[0].take(l0_slot))
                 {
                     results.push_back(task.data);
                 }
-                levels[0].slots[l0_slot].clear();
-
-                // 🌟 底层任务执行完毕，清除位图标志
-                levels[0].clear_bit(l0_slot);
             }
         }
 
@@ -111,11 +207,14 @@ class BitwiseTimerWheel
         return results;
     }
 
-    void add_timer(MS delay, void* data)
+    void add_timer(MS delay, void* data) { add_timer(delay, data, current_ms()); }
+
+    void add_timer(MS delay, void* data, uint64_t now)
     {
-        uint64_t delay_ticks = delay.count() / tick_interval_ms;
-        if (delay_ticks == 0)
-            delay_ticks = 1;
+        // 从 last_tick_time 而不是 now 算起，长时间未 update 时已经过去的 tick 也算上；
+        // now 只精确到毫秒，真实时间可能已经走过了大半毫秒，到期时间多留 1ms 并向上取整到 tick，保证不会提前触发
+        uint64_t deadline = std::max(now, last_tick_time) + delay.count() + 1;
+        uint64_t delay_ticks = (deadline - last_tick_time + tick_interval_ms - 1) / tick_interval_ms;
         if (delay_ticks >= max_range)
             delay_ticks = max_range - 1;
 
@@ -123,50 +222,21 @@ class BitwiseTimerWheel
         insert_task(std::move(task));
     }
 
-    // 🌟 终极位图加速查找
-    int64_t get_next_timeout() const
+    // 🌟 每层缓存最早到期时间，常态下 O(层数)
+    int64_t get_next_timeout()
     {
         uint64_t min_expire = UINT64_MAX;
-        bool found = false;
 
-        // 从最低层开始找（低层任务永远比高层任务先到期）
-        for (size_t i = 0; i < levels.size(); ++i)
+        // 高层任务也可能比低层任务先到期，所以取所有层的最小值
+        for (auto& level : levels)
         {
-            // 扫描该层的位图数组
-            for (size_t w = 0; w < levels[i].bitmap.size(); ++w)
+            if (auto expire = level.earliest(); expire < min_expire)
             {
-                uint64_t word = levels[i].bitmap[w];
-
-                // 只要这个 word 不为 0，说明里面有槽位包含任务
-                while (word != 0)
-                {
-                    // 硬件级指令：获取最低位连续的 0 的个数 (即最低位的 1 的索引)
-                    // 注意: __builtin_ctzll 是 GCC/Clang 特有指令
-                    int bit_idx = __builtin_ctzll(word);
-
-                    size_t slot = (w << 6) + bit_idx; // 还原真实的槽位索引
-
-                    // 遍历该槽位，寻找真实的最小 expire_tick
-                    for (const auto& task : levels[i].slots[slot])
-                    {
-                        if (task.expire_tick < min_expire)
-                        {
-                            min_expire = task.expire_tick;
-                            found = true;
-                        }
-                    }
-
-                    // 极速清除最低位的 1，继续寻找这个 word 里下一个非空的槽位
-                    word &= word - 1;
-                }
+                min_expire = expire;
             }
-
-            // 只要在这一层找到了任务，就绝对不用再去高层找了！
-            if (found)
-                break;
         }
 
-        if (!found)
+        if (min_expire == UINT64_MAX)
             return -1; // 整个轮子是空的
 
         if (min_expire <= current_tick)
@@ -186,15 +256,36 @@ class BitwiseTimerWheel
             if (diff < levels[i].total_range || i == levels.size() - 1)
             {
                 size_t slot = (task.expire_tick >> levels[i].shift) & levels[i].slot_mask;
-                levels[i].slots[slot].push_back(std::move(task));
-
                 // 🌟 新增任务，设置位图标志
-                levels[i].set_bit(slot);
+                levels[i].push(slot, std::move(task));
                 return;
             }
         }
     }
 
+    // 下一个需要处理的 tick：底层槽位到期，或者高层非空槽位需要降级
+    uint64_t next_event_tick() const
+    {
+        uint64_t next = UINT64_MAX;
+        for (size_t lvl = 0; lvl < levels.size(); ++lvl)
+        {
+            const auto& level = levels[lvl];
+            // 第 lvl 层只在 tick 是 2^shift 的整数倍时被检查
+            uint64_t base = current_tick >> level.shift;
+            auto distance = level.distance_to_next((base + 1) & level.slot_mask);
+            if (distance == WheelLevel::npos)
+            {
+                continue;
+            }
+            uint64_t tick = (base + 1 + distance) << level.shift;
+            if (tick < next)
+            {
+                next = tick;
+            }
+        }
+        return next;
+    }
+
     uint64_t current_ms() const { return std::chrono::duration_cast<MS>(Clock::now().time_since_epoch()).count(); }
 
     uint64_t tick_interval_ms;
@@ -202,4 +293,4 @@ class BitwiseTimerWheel
     uint64_t current_tick;
     uint64_t max_range;
     std::vector<WheelLevel> levels;
-};
\ No newline at end of file
+};
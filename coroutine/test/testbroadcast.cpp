@@ -0,0 +1,274 @@
+#include "coroutine/broadcast.h"
+#include "coroutine/coroutine.h"
+#include "coroutine/cospawn.h"
+#include "coroutine/main.h"
+#include "coroutine/syscall.h"
+#include "coroutine/waitgroup.h"
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace utils
+{
+
+// ============================================================================
+// 测试1: 每个订阅者收到同一份数据
+// ============================================================================
+auto test_fan_out() -> Coroutine<>
+{
+    std::cout << "=== Test 1: Fan-out Shares Payload ===" << std::endl;
+
+    BroadcastChannel<std::string, 4> channel;
+    // 订阅之前发送的数据没有人收
+    co_await channel.send("lost");
+    auto a = channel.subscribe();
+    auto b = channel.subscribe();
+    assert(channel.subscriber_count() == 2);
+
+    auto payload = std::make_shared<const std::string>("config v1");
+    auto state = co_await channel.send(payload);
+    assert(state == State::OK);
+    auto [pa, sa] = co_await a.recv();
+    auto [pb, sb] = co_await b.recv();
+    assert(sa == State::OK && sb == State::OK);
+    assert(pa.get() == payload.get());
+    assert(pb.get() == payload.get());
+    assert(!a.try_recv());
+
+    // 所有订阅者读完后槽位不再持有数据
+    pa.reset();
+    pb.reset();
+    assert(payload.use_count() == 1);
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试2: 挂起的订阅者由发送方直接唤醒
+// ============================================================================
+auto test_wake_subscribers() -> Coroutine<>
+{
+    std::cout << "=== Test 2: Wake Subscribers ===" << std::endl;
+
+    BroadcastChannel<int, 4> channel;
+    WaitGroup wg;
+    constexpr int subscribers = 8;
+    for (int i = 0; i < subscribers; ++i)
+    {
+        wg.add(1);
+        co_spawn([](WaitGroup& wg, BroadcastChannel<int, 4>::Subscriber subscriber) -> Coroutine<> {
+            auto done = DoneGuard(wg);
+            auto [payload, state] = co_await subscriber.recv();
+            assert(state == State::OK);
+            assert(*payload == 42);
+        }(wg, channel.subscribe()));
+    }
+    co_await delay(std::chrono::milliseconds(10));
+    co_await channel.send(42);
+    co_await wg.wait();
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试3: DropOldest 策略下落后的订阅者跳过被覆盖的数据
+// ============================================================================
+auto test_drop_oldest() -> Coroutine<>
+{
+    std::cout << "=== Test 3: Drop Oldest ===" << std::endl;
+
+    BroadcastChannel<int, 4, LagPolicy::DropOldest> channel;
+    auto subscriber = channel.subscribe();
+    for (int i = 0; i < 10; ++i)
+    {
+        // 不会因为订阅者落后而挂起
+        assert(channel.try_send(std::make_shared<const int>(i)));
+    }
+    for (int i = 6; i < 10; ++i)
+    {
+        auto [payload, state] = co_await subscriber.recv();
+        assert(state == State::OK);
+        assert(*payload == i);
+    }
+    assert(subscriber.lagged() == 6);
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试4: Block 策略下发送者等最慢的订阅者
+// ============================================================================
+auto test_block() -> Coroutine<>
+{
+    std::cout << "=== Test 4: Block ===" << std::endl;
+
+    using Channel = BroadcastChannel<int, 2, LagPolicy::Block>;
+    Channel channel;
+    auto fast = channel.subscribe();
+    auto slow = channel.subscribe();
+    co_await channel.send(0);
+    co_await channel.send(1);
+    assert(!channel.try_send(std::make_shared<const int>(2)));
+
+    WaitGroup wg;
+    wg.add(1);
+    bool sent = false;
+    co_spawn([](WaitGroup& wg, Channel& channel, bool& sent) -> Coroutine<> {
+        auto done = DoneGuard(wg);
+        auto state = co_await channel.send(2);
+        assert(state == State::OK);
+        sent = true;
+    }(wg, channel, sent));
+
+    // 快的订阅者读完也不能腾出槽位
+    for (int i = 0; i < 2; ++i)
+    {
+        auto [payload, state] = co_await fast.recv();
+        assert(*payload == i);
+    }
+    co_await delay(std::chrono::milliseconds(10));
+    assert(!sent);
+    auto [payload, state] = co_await slow.recv();
+    assert(*payload == 0);
+    co_await wg.wait();
+    assert(sent);
+    std::tie(payload, state) = co_await fast.recv();
+    assert(*payload == 2);
+
+    // 退订也会释放槽位
+    slow.reset();
+    assert(channel.subscriber_count() == 1);
+    assert(channel.try_send(std::make_shared<const int>(3)));
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试5: 关闭后读完剩余数据再返回 CLOSED，挂起的订阅者被唤醒
+// ============================================================================
+auto test_close() -> Coroutine<>
+{
+    std::cout << "=== Test 5: Close ===" << std::endl;
+
+    using Channel = BroadcastChannel<int, 4>;
+    Channel channel;
+    auto buffered = channel.subscribe();
+    WaitGroup wg;
+    wg.add(1);
+    co_spawn([](WaitGroup& wg, Channel::Subscriber subscriber) -> Coroutine<> {
+        auto done = DoneGuard(wg);
+        auto [payload, state] = co_await subscriber.recv();
+        assert(*payload == 1);
+        std::tie(payload, state) = co_await subscriber.recv();
+        assert(state == State::CLOSED);
+        assert(!payload);
+    }(wg, channel.subscribe()));
+    co_await channel.send(1);
+    co_await delay(std::chrono::milliseconds(10));
+    channel.close();
+    co_await wg.wait();
+
+    auto [payload, state] = co_await buffered.recv();
+    assert(state == State::OK && *payload == 1);
+    std::tie(payload, state) = co_await buffered.recv();
+    assert(state == State::CLOSED);
+    assert(co_await channel.send(2) == State::CLOSED);
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试6: 多个生产者，每个订阅者按发送顺序收到全部数据
+// ============================================================================
+auto test_stress() -> Coroutine<>
+{
+    std::cout << "=== Test 6: Stress ===" << std::endl;
+
+    using Channel = BroadcastChannel<int, 16, LagPolicy::Block>;
+    constexpr int producers = 4;
+    constexpr int subscribers = 8;
+    constexpr int items = 5000;
+    Channel channel;
+    WaitGroup senders;
+    WaitGroup receivers;
+    for (int i = 0; i < subscribers; ++i)
+    {
+        receivers.add(1);
+        co_spawn([](WaitGroup& wg, Channel::Subscriber subscriber) -> Coroutine<> {
+            auto done = DoneGuard(wg);
+            std::vector<int> last(producers, -1);
+            int count = 0;
+            while (true)
+            {
+                auto [payload, state] = co_await subscriber.recv();
+                if (state == State::CLOSED)
+                {
+                    break;
+                }
+                // 同一个生产者的数据保持顺序
+                auto producer = *payload / items;
+                assert(*payload % items == last[producer] + 1);
+                last[producer] = *payload % items;
+                ++count;
+            }
+            assert(count == producers * items);
+            assert(subscriber.lagged() == 0);
+        }(receivers, channel.subscribe()));
+    }
+    for (int i = 0; i < producers; ++i)
+    {
+        senders.add(1);
+        co_spawn([](WaitGroup& wg, Channel& channel, int base) -> Coroutine<> {
+            auto done = DoneGuard(wg);
+            for (int j = 0; j < items; ++j)
+            {
+                co_await channel.send(base + j);
+            }
+        }(senders, channel, i * items));
+    }
+    co_await senders.wait();
+    channel.close();
+    co_await receivers.wait();
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 主协程：运行所有测试
+// ============================================================================
+auto main_coro() -> MainCoroutine
+{
+    std::cout << "========================================" << std::endl;
+    std::cout << "      Broadcast Channel Test Suite      " << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    co_await test_fan_out();
+    std::cout << std::endl;
+
+    co_await test_wake_subscribers();
+    std::cout << std::endl;
+
+    co_await test_drop_oldest();
+    std::cout << std::endl;
+
+    co_await test_block();
+    std::cout << std::endl;
+
+    co_await test_close();
+    std::cout << std::endl;
+
+    co_await test_stress();
+    std::cout << std::endl;
+
+    std::cout << "========================================" << std::endl;
+    std::cout << "   All Tests PASSED!   " << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    co_return 0;
+}
+
+} // namespace utils
@@ -2,9 +2,13 @@
 #include "coroutine/coroutine.h"
 #include "coroutine/cospawn.h"
 #include "coroutine/main.h"
+#include "coroutine/syscall.h"
 #include "coroutine/waitgroup.h"
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <iostream>
+#include <string>
 #include <vector>
 
 namespace utils
@@ -337,6 +341,300 @@ auto test_multi_producer_consumer() -> Coroutine<>
     std::cout << "PASSED: Sent " << total_sent << ", Received " << total_recv << std::endl;
 }
 
+// ============================================================================
+// 测试8: 不挂起的 try_send / try_recv
+// ============================================================================
+auto test_try_ops() -> Coroutine<>
+{
+    std::cout << "=== Test 8: try_send / try_recv ===" << std::endl;
+
+    Channel<int, 2> ch;
+    int value = 1;
+    assert(ch.try_send(std::move(value)));
+    value = 2;
+    assert(ch.try_send(std::move(value)));
+    value = 3;
+    // 已满，值保持不变
+    assert(!ch.try_send(std::move(value)));
+    assert(value == 3);
+    assert(ch.try_recv() == 1);
+    assert(ch.try_recv() == 2);
+    assert(!ch.try_recv());
+
+    // 无缓冲 channel 只有对端挂起时才能成功
+    Channel<int, 0> unbuffered;
+    value = 4;
+    assert(!unbuffered.try_send(std::move(value)));
+    WaitGroup wg;
+    wg.add(1);
+    auto receiver = [](WaitGroup& wg, Channel<int, 0>& ch) -> Coroutine<> {
+        auto done = DoneGuard(wg);
+        auto [value, state] = co_await ch.recv();
+        assert(state == State::OK);
+        assert(value == 4);
+    };
+    co_spawn(receiver(wg, unbuffered));
+    while (!unbuffered.try_send(std::move(value)))
+    {
+        co_await delay(std::chrono::milliseconds(1));
+    }
+    co_await wg.wait();
+
+    Channel<void, 1> signal;
+    assert(signal.try_send());
+    assert(!signal.try_send());
+    assert(signal.try_recv());
+    assert(!signal.try_recv());
+
+    // 容量不是 2 的幂时槽位向上取整，但最多只能放 Capacity 个
+    Channel<int, 1> single;
+    value = 6;
+    assert(single.try_send(std::move(value)));
+    value = 7;
+    assert(!single.try_send(std::move(value)));
+    assert(single.try_recv() == 6);
+    assert(single.try_send(std::move(value)));
+    assert(single.try_recv() == 7);
+    assert(!single.try_recv());
+
+    Channel<int, 3> three;
+    for (int i = 0; i < 3; ++i)
+    {
+        value = i;
+        assert(three.try_send(std::move(value)));
+    }
+    value = 3;
+    assert(!three.try_send(std::move(value)));
+    assert(three.try_recv() == 0);
+    assert(three.try_send(std::move(value)));
+    assert(!three.try_send(std::move(value)));
+
+    ch.close();
+    value = 5;
+    assert(!ch.try_send(std::move(value)));
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试9: 批量收发 recv_many / send_many
+// ============================================================================
+template <size_t Capacity> auto test_batch_ops() -> Coroutine<>
+{
+    std::cout << "=== Test 9: recv_many / send_many (capacity " << Capacity << ") ===" << std::endl;
+
+    constexpr int items = 10000;
+    constexpr int producers = 4;
+    Channel<int, Capacity> ch;
+    WaitGroup wg;
+    wg.add(producers);
+    auto producer = [](WaitGroup& wg, Channel<int, Capacity>& ch, int base) -> Coroutine<> {
+        auto done = DoneGuard(wg);
+        std::vector<int> values(100);
+        for (int i = 0; i < items; i += 100)
+        {
+            for (int j = 0; j < 100; ++j)
+            {
+                values[j] = base + i + j;
+            }
+            auto sent = co_await ch.send_many(values);
+            assert(sent == values.size());
+        }
+    };
+    for (int p = 0; p < producers; ++p)
+    {
+        co_spawn(producer(wg, ch, p * items));
+    }
+    auto closer = [](WaitGroup& wg, Channel<int, Capacity>& ch) -> Coroutine<> {
+        co_await wg.wait();
+        ch.close();
+    };
+    co_spawn(closer(wg, ch));
+
+    std::vector<int> seen(producers * items, 0);
+    // 每个生产者的数据按顺序到达
+    std::vector<int> last(producers, -1);
+    std::vector<int> buffer(64);
+    size_t batches = 0;
+    while (true)
+    {
+        auto count = co_await ch.recv_many(buffer);
+        if (count == 0)
+        {
+            break;
+        }
+        ++batches;
+        for (size_t i = 0; i < count; ++i)
+        {
+            auto value = buffer[i];
+            ++seen[value];
+            assert(value > last[value / items]);
+            last[value / items] = value;
+        }
+    }
+    for (auto count : seen)
+    {
+        assert(count == 1);
+    }
+
+    std::cout << "PASSED: " << producers * items << " items in " << batches << " batches" << std::endl;
+}
+
+// ============================================================================
+// 测试10: 运行时容量的 channel
+// ============================================================================
+auto test_dynamic_capacity() -> Coroutine<>
+{
+    std::cout << "=== Test 10: Dynamic Capacity ===" << std::endl;
+
+    // 容量不必是 2 的幂
+    Channel<std::string, DynamicCapacity> ch(3);
+    for (int i = 0; i < 3; ++i)
+    {
+        auto state = co_await ch.send(std::to_string(i));
+        assert(state == State::OK);
+    }
+    std::string value = "3";
+    assert(!ch.try_send(std::move(value)));
+    for (int i = 0; i < 3; ++i)
+    {
+        assert(ch.try_recv() == std::to_string(i));
+    }
+    assert(!ch.try_recv());
+
+    // 存储增长到上千个元素再收缩，保持FIFO
+    Channel<int, DynamicCapacity> large(5000);
+    for (int round = 0; round < 3; ++round)
+    {
+        for (int i = 0; i < 5000; ++i)
+        {
+            auto state = co_await large.send(i);
+            assert(state == State::OK);
+        }
+        for (int i = 0; i < 5000; ++i)
+        {
+            auto [v, state] = co_await large.recv();
+            assert(state == State::OK);
+            assert(v == i);
+        }
+    }
+
+    // 多生产者多消费者
+    Channel<int, DynamicCapacity> shared(100);
+    constexpr int items = 20000;
+    WaitGroup producers;
+    WaitGroup consumers;
+    std::atomic<long> sum{0};
+    producers.add(4);
+    consumers.add(4);
+    for (int p = 0; p < 4; ++p)
+    {
+        co_spawn([](WaitGroup& wg, Channel<int, DynamicCapacity>& ch, int base) -> Coroutine<> {
+            auto done = DoneGuard(wg);
+            for (int i = 0; i < items; ++i)
+            {
+                co_await ch.send(base + i);
+            }
+        }(producers, shared, p * items));
+    }
+    for (int c = 0; c < 4; ++c)
+    {
+        co_spawn([](WaitGroup& wg, Channel<int, DynamicCapacity>& ch, std::atomic<long>& sum) -> Coroutine<> {
+            auto done = DoneGuard(wg);
+            while (true)
+            {
+                auto [v, state] = co_await ch.recv();
+                if (state != State::OK)
+                {
+                    break;
+                }
+                sum += v;
+            }
+        }(consumers, shared, sum));
+    }
+    co_await producers.wait();
+    shared.close();
+    co_await consumers.wait();
+    long n = 4L * items;
+    assert(sum == n * (n - 1) / 2);
+
+    // 容量为 0 时与无缓冲 channel 相同
+    Channel<int, DynamicCapacity> unbuffered(0);
+    int x = 1;
+    assert(!unbuffered.try_send(std::move(x)));
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试11: 单生产者单消费者 channel
+// ============================================================================
+auto test_spsc() -> Coroutine<>
+{
+    std::cout << "=== Test 11: SPSC Channel ===" << std::endl;
+
+    using Spsc = Channel<std::string, 4, ChannelMode::SPSC>;
+    Spsc ch;
+    for (int i = 0; i < 4; ++i)
+    {
+        assert(co_await ch.send(std::to_string(i)) == State::OK);
+    }
+    std::string value = "4";
+    assert(!ch.try_send(std::move(value)));
+    assert(ch.try_recv() == "0");
+    assert(ch.try_send(std::move(value)));
+    for (int i = 1; i <= 4; ++i)
+    {
+        auto [v, state] = co_await ch.recv();
+        assert(state == State::OK);
+        assert(v == std::to_string(i));
+    }
+    assert(!ch.try_recv());
+
+    // 双方交替挂起，保持FIFO
+    constexpr int items = 200000;
+    Channel<int, 8, ChannelMode::SPSC> pipe;
+    WaitGroup wg;
+    wg.add(1);
+    co_spawn([](WaitGroup& wg, Channel<int, 8, ChannelMode::SPSC>& pipe) -> Coroutine<> {
+        auto done = DoneGuard(wg);
+        for (int i = 0; i < items; ++i)
+        {
+            auto state = co_await pipe.send(i);
+            assert(state == State::OK);
+        }
+        pipe.close();
+    }(wg, pipe));
+    int expected = 0;
+    while (true)
+    {
+        auto [v, state] = co_await pipe.recv();
+        if (state != State::OK)
+        {
+            break;
+        }
+        assert(v == expected);
+        ++expected;
+    }
+    assert(expected == items);
+    co_await wg.wait();
+
+    // 关闭唤醒挂起的接收者，之后发送失败
+    Channel<int, 2, ChannelMode::SPSC> closing;
+    wg.add(1);
+    co_spawn([](WaitGroup& wg, Channel<int, 2, ChannelMode::SPSC>& ch) -> Coroutine<> {
+        auto done = DoneGuard(wg);
+        auto [v, state] = co_await ch.recv();
+        assert(state == State::CLOSED);
+    }(wg, closing));
+    co_await delay(std::chrono::milliseconds(5));
+    closing.close();
+    co_await wg.wait();
+    assert(co_await closing.send(1) == State::CLOSED);
+
+    std::cout << "PASSED" << std::endl;
+}
+
 // ============================================================================
 // 主协程：运行所有测试
 // ============================================================================
@@ -368,6 +666,27 @@ auto main_coro() -> MainCoroutine
     co_await test_multi_producer_consumer();
     std::cout << std::endl;
 
+    co_await test_try_ops();
+    std::cout << std::endl;
+
+    co_await test_batch_ops<0>();
+    std::cout << std::endl;
+
+    co_await test_batch_ops<1>();
+    std::cout << std::endl;
+
+    co_await test_batch_ops<3>();
+    std::cout << std::endl;
+
+    co_await test_batch_ops<64>();
+    std::cout << std::endl;
+
+    co_await test_dynamic_capacity();
+    std::cout << std::endl;
+
+    co_await test_spsc();
+    std::cout << std::endl;
+
     std::cout << "========================================" << std::endl;
     std::cout << "   All Tests PASSED!   " << std::endl;
     std::cout << "========================================" << std::endl;
@@ -0,0 +1,187 @@
+#include "coroutine/coroutine.h"
+#include "coroutine/file.h"
+#include "coroutine/main.h"
+#include <array>
+#include <cassert>
+#include <cstdio>
+#include <iostream>
+#include <liburing.h>
+#include <poll.h>
+#include <string>
+#include <unistd.h>
+
+namespace utils
+{
+
+// ============================================================================
+// 测试1: 打开、指定偏移写入、fsync、stat
+// ============================================================================
+auto test_write_and_stat(const std::string& path) -> Coroutine<>
+{
+    std::cout << "=== Test 1: Write At Offset And Stat ===" << std::endl;
+
+    auto file = co_await AsyncFile::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    assert(file.is_valid());
+
+    std::string head = "hello ";
+    std::string tail = "world";
+    // 先写后半段，再写前半段，验证偏移生效
+    auto n = co_await file.write_at(tail, head.size());
+    assert(n == static_cast<int>(tail.size()));
+    n = co_await file.write_at(head, 0);
+    assert(n == static_cast<int>(head.size()));
+    auto res = co_await file.fsync();
+    assert(res == 0);
+
+    struct statx stx{};
+    res = co_await file.stat(stx);
+    assert(res == 0);
+    assert(S_ISREG(stx.stx_mode));
+    assert(stx.stx_size == head.size() + tail.size());
+    res = co_await file.close();
+    assert(res == 0);
+    assert(!file.is_valid());
+
+    std::cout << "  Size: " << stx.stx_size << std::endl;
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试2: 分块流式读取与整体读取
+// ============================================================================
+auto test_chunked_read(const std::string& path) -> Coroutine<>
+{
+    std::cout << "=== Test 2: Chunked Read ===" << std::endl;
+
+    auto file = co_await AsyncFile::open(path);
+    assert(file.is_valid());
+
+    std::string content;
+    std::array<char, 4> chunk;
+    while (true)
+    {
+        auto n = co_await file.read_chunk(chunk);
+        assert(n >= 0);
+        if (n == 0)
+        {
+            break;
+        }
+        content.append(chunk.data(), n);
+    }
+    assert(content == "hello world");
+
+    auto [all, error] = co_await file.read_all(3);
+    assert(error == 0);
+    assert(all == "hello world");
+    co_await file.close();
+
+    // 读取出错不能当作文件结束
+    auto write_only = co_await AsyncFile::open(path, O_WRONLY);
+    assert(write_only.is_valid());
+    std::tie(all, error) = co_await write_only.read_all();
+    assert(error == -EBADF);
+    assert(all.empty());
+    co_await write_only.close();
+
+    std::cout << "  Content: " << content << std::endl;
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试3: 打开不存在的文件
+// ============================================================================
+auto test_open_missing() -> Coroutine<>
+{
+    std::cout << "=== Test 3: Open Missing File ===" << std::endl;
+
+    auto file = co_await AsyncFile::open("/nonexistent/coroutine_test_file");
+    assert(!file.is_valid());
+    assert(file.error() == -ENOENT);
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试4: 通用 io_uring 操作（poll_add 监听第三方 fd）
+// ============================================================================
+auto test_uring_op() -> Coroutine<>
+{
+    std::cout << "=== Test 4: Generic Uring Op ===" << std::endl;
+
+    int fds[2];
+    auto res = ::pipe2(fds, O_NONBLOCK | O_CLOEXEC);
+    assert(res == 0);
+    char byte = 'x';
+    auto written = ::write(fds[1], &byte, 1);
+    assert(written == 1);
+
+    int fd = fds[0];
+    auto events = co_await uring_op([fd](io_uring_sqe* sqe) { io_uring_prep_poll_add(sqe, fd, POLLIN); });
+    assert(events & POLLIN);
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+    std::cout << "  Events: " << events << std::endl;
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试5: 按路径读取
+// ============================================================================
+auto test_read_by_path(const std::string& path) -> Coroutine<>
+{
+    std::cout << "=== Test 5: Read By Path ===" << std::endl;
+
+    std::array<char, 64> data{};
+    auto n = co_await read(path, data.data(), data.size());
+    assert(n == 11);
+    assert(std::string(data.data(), n) == "hello world");
+
+    // 只读 nbytes 字节
+    n = co_await read(path, data.data(), 5);
+    assert(n == 5);
+    assert(std::string(data.data(), n) == "hello");
+
+    n = co_await read("/nonexistent/coroutine_test_file", data.data(), data.size());
+    assert(n == -ENOENT);
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 主协程：运行所有测试
+// ============================================================================
+auto main_coro() -> MainCoroutine
+{
+    std::cout << "========================================" << std::endl;
+    std::cout << "      AsyncFile Test Suite              " << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    std::string path = "/tmp/coroutine_test_file.txt";
+
+    co_await test_write_and_stat(path);
+    std::cout << std::endl;
+
+    co_await test_chunked_read(path);
+    std::cout << std::endl;
+
+    co_await test_open_missing();
+    std::cout << std::endl;
+
+    co_await test_uring_op();
+    std::cout << std::endl;
+
+    co_await test_read_by_path(path);
+    std::cout << std::endl;
+
+    std::remove(path.c_str());
+
+    std::cout << "========================================" << std::endl;
+    std::cout << "   All Tests PASSED!   " << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    co_return 0;
+}
+
+} // namespace utils
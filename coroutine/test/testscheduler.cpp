@@ -1,10 +1,13 @@
 #include "coroutine/coroutine.h"
 #include "coroutine/cospawn.h"
+#include "coroutine/iostats.h"
 #include "coroutine/main.h"
+#include "coroutine/syscall.h"
 #include "coroutine/waitgroup.h"
 #include <algorithm>
 #include <atomic>
 #include <cassert>
+#include <chrono>
 #include <iostream>
 #include <numeric>
 #include <random>
@@ -428,6 +431,272 @@ auto test_chained_execution() -> Coroutine<>
     std::cout << "PASSED" << std::endl;
 }
 
+// ============================================================================
+// 测试11: 延时（时间轮与 io_uring 高精度超时）
+// ============================================================================
+auto test_delay() -> Coroutine<>
+{
+    std::cout << "=== Test 11: Delay ===" << std::endl;
+
+    using namespace std::chrono;
+    // 低于时间轮精度，走 IORING_OP_TIMEOUT
+    for (auto timeout : {microseconds(50), microseconds(200), microseconds(800)})
+    {
+        auto start = steady_clock::now();
+        auto res = co_await delay(timeout);
+        auto elapsed = duration_cast<microseconds>(steady_clock::now() - start);
+        assert(res == 0);
+        assert(elapsed >= timeout);
+        std::cout << "  delay " << timeout.count() << "us, elapsed " << elapsed.count() << "us" << std::endl;
+    }
+
+    // 走时间轮
+    auto start = steady_clock::now();
+    co_await delay(milliseconds(5));
+    auto elapsed = duration_cast<milliseconds>(steady_clock::now() - start);
+    assert(elapsed >= milliseconds(4));
+    std::cout << "  delay 5ms, elapsed " << elapsed.count() << "ms" << std::endl;
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试12: io_uring 提交批处理统计
+// ============================================================================
+auto test_submit_stats() -> Coroutine<>
+{
+    std::cout << "=== Test 12: Submit Stats ===" << std::endl;
+    if (io_backend() != IoBackend::URING)
+    {
+        std::cout << "SKIPPED (epoll backend)" << std::endl;
+        co_return;
+    }
+
+    set_submit_policy({.max_batch = 16, .max_delay = std::chrono::microseconds(20)});
+    // 短延迟走 IORING_OP_TIMEOUT，必然产生 SQE 提交
+    for (int i = 0; i < 8; ++i)
+    {
+        co_await delay(std::chrono::microseconds(100));
+    }
+
+    uint64_t calls = 0;
+    uint64_t sqes = 0;
+    for (const auto& stats : submit_stats())
+    {
+        uint64_t buckets = 0;
+        for (auto count : stats.batch_histogram)
+        {
+            buckets += count;
+        }
+        assert(buckets == stats.submit_calls);
+        assert(stats.submitted_sqes >= stats.submit_calls);
+        calls += stats.submit_calls;
+        sqes += stats.submitted_sqes;
+    }
+    assert(calls > 0);
+    assert(sqes >= 8);
+
+    // max_batch = 1 时每个 SQE 在申请时立即单独提交，不等 poll 或 max_delay
+    set_submit_policy({.max_batch = 1, .max_delay = std::chrono::seconds(1)});
+    int self = current_processor();
+    auto before = submit_stats()[self];
+    constexpr int timeouts = 4;
+    WaitGroup wg;
+    wg.add(timeouts);
+    for (int i = 0; i < timeouts; ++i)
+    {
+        // 固定在本 P 上连续运行，中间没有 poll，未立即提交的 SQE 会与下一个合并成一批
+        co_spawn_pinned(
+            [](WaitGroup& wg) -> Coroutine<> {
+                co_await delay(std::chrono::microseconds(50));
+                wg.done();
+            }(wg),
+            self);
+    }
+    co_await wg.wait();
+    auto after = submit_stats()[self];
+    assert(after.submit_calls - before.submit_calls >= timeouts);
+    assert(after.submitted_sqes - before.submitted_sqes == after.submit_calls - before.submit_calls);
+    set_submit_policy({});
+
+    std::cout << "  Submits: " << calls << ", SQEs: " << sqes << std::endl;
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试13: CQ 忙轮询
+// ============================================================================
+auto spin_probe(std::chrono::microseconds wait, int rounds, WaitGroup& wg) -> Coroutine<>
+{
+    for (int i = 0; i < rounds; ++i)
+    {
+        auto start = std::chrono::steady_clock::now();
+        co_await delay(wait);
+        assert(std::chrono::steady_clock::now() - start >= wait);
+    }
+    wg.done();
+}
+
+auto test_spin_poll() -> Coroutine<>
+{
+    std::cout << "=== Test 13: Spin Poll ===" << std::endl;
+    if (io_backend() != IoBackend::URING)
+    {
+        std::cout << "SKIPPED (epoll backend)" << std::endl;
+        co_return;
+    }
+
+    using namespace std::chrono;
+    constexpr auto cap = microseconds(200);
+    int self = current_processor();
+    WaitGroup wg;
+
+    // 固定窗口：100us 的超时在 200us 的轮询窗口内完成，应当命中
+    // 自适应窗口可能已被之前的空闲轮询缩到最小，等不到 100us，因此这里关闭自适应
+    set_spin_policy({.max_spin = cap, .adaptive = false});
+    auto before = poll_stats()[self];
+    wg.add(1);
+    co_spawn_pinned(spin_probe(microseconds(100), 16, wg), self);
+    co_await wg.wait();
+    auto after = poll_stats()[self];
+    uint64_t hits = after.spin_hits - before.spin_hits;
+    assert(hits > 0);
+
+    // 自适应窗口：等待远长于上限时每次都轮询超时，窗口随之减半
+    set_spin_policy({.max_spin = cap});
+    before = after;
+    wg.add(1);
+    co_spawn_pinned(spin_probe(milliseconds(2), 8, wg), self);
+    co_await wg.wait();
+    after = poll_stats()[self];
+    uint64_t misses = after.spin_misses - before.spin_misses;
+    assert(misses >= 8);
+    assert(after.spin_window < cap);
+    set_spin_policy({});
+
+    for (const auto& stats : poll_stats())
+    {
+        // 学习到的窗口不会超过上限
+        assert(stats.spin_window <= cap);
+    }
+
+    std::cout << "  Spin hits: " << hits << ", misses: " << misses
+              << ", window: " << duration_cast<microseconds>(after.spin_window).count() << "us" << std::endl;
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试14: 固定 home P
+// ============================================================================
+auto pinned_worker(int home, std::atomic<int>& misplaced, WaitGroup& wg) -> Coroutine<>
+{
+    for (int i = 0; i < 20; ++i)
+    {
+        if (current_processor() != home)
+        {
+            misplaced.fetch_add(1);
+        }
+        if (i % 2 == 0)
+        {
+            co_yield {};
+        }
+        else
+        {
+            co_await delay(std::chrono::microseconds(50));
+        }
+    }
+    wg.done();
+}
+
+auto test_pinning() -> Coroutine<>
+{
+    std::cout << "=== Test 14: Processor Pinning ===" << std::endl;
+
+    constexpr int num_coros = 64;
+    std::atomic<int> misplaced{0};
+    WaitGroup wg;
+    wg.add(num_coros);
+    for (int i = 0; i < num_coros; ++i)
+    {
+        auto policy = i % 2 == 0 ? PinPolicy::ROUND_ROBIN : PinPolicy::LEAST_LOADED;
+        auto home = pick_processor(policy);
+        assert(home >= 0);
+        co_spawn_pinned(pinned_worker(home, misplaced, wg), home);
+    }
+    co_await wg.wait();
+    assert(pick_processor(PinPolicy::NONE) == -1);
+    assert(misplaced.load() == 0);
+
+    std::cout << "  Pinned coroutines: " << num_coros << ", misplaced resumes: " << misplaced.load() << std::endl;
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试15: 忙碌 P 的完成事件被空闲 P 收割
+// ============================================================================
+auto harvest_target(int home, std::atomic<bool>& misplaced, WaitGroup& wg) -> Coroutine<>
+{
+    co_await delay(std::chrono::microseconds(200));
+    // 被其他 P 收割后仍回到 home 上恢复
+    misplaced.store(current_processor() != home);
+    wg.done();
+}
+
+auto harvested_cqes() -> uint64_t
+{
+    uint64_t harvested = 0;
+    for (const auto& stats : poll_stats())
+    {
+        harvested += stats.harvested_cqes;
+    }
+    return harvested;
+}
+
+auto busy_owner(int home, std::atomic<bool>& misplaced, std::atomic<bool>& observed, WaitGroup& wg) -> Coroutine<>
+{
+    auto before = harvested_cqes();
+    co_spawn_pinned(harvest_target(home, misplaced, wg), home);
+    // 让 harvest_target 先在 home 上提交 IO
+    co_yield {};
+    // 不让出 CPU，模拟长时间运行的协程，期间 home 自己无法收割 CQ，只能由其他 P 代为收割
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+    while (harvested_cqes() == before && std::chrono::steady_clock::now() < deadline)
+    {
+    }
+    observed.store(harvested_cqes() > before);
+    wg.done();
+}
+
+auto test_harvest() -> Coroutine<>
+{
+    std::cout << "=== Test 15: Completion Harvesting ===" << std::endl;
+    if (processor_count() < 2)
+    {
+        std::cout << "SKIPPED (single processor)" << std::endl;
+        co_return;
+    }
+    if (io_backend() != IoBackend::URING)
+    {
+        std::cout << "SKIPPED (epoll backend)" << std::endl;
+        co_return;
+    }
+
+    // 每个 SQE 立即提交，保证 IO 在长协程开始前已进入内核；max_delay 放长，不依赖超时提交
+    set_submit_policy({.max_batch = 1, .max_delay = std::chrono::seconds(1)});
+    std::atomic<bool> misplaced{true};
+    std::atomic<bool> observed{false};
+    WaitGroup wg;
+    wg.add(2);
+    int home = static_cast<int>(processor_count()) - 1;
+    co_spawn_pinned(busy_owner(home, misplaced, observed, wg), home);
+    co_await wg.wait();
+    set_submit_policy({});
+    assert(observed.load());
+    assert(!misplaced.load());
+
+    std::cout << "  Harvested CQEs: " << harvested_cqes() << std::endl;
+    std::cout << "PASSED" << std::endl;
+}
+
 // ============================================================================
 // 主协程：运行所有测试
 // ============================================================================
@@ -468,6 +737,21 @@ auto main_coro() -> MainCoroutine
     co_await test_chained_execution();
     std::cout << std::endl;
 
+    co_await test_delay();
+    std::cout << std::endl;
+
+    co_await test_submit_stats();
+    std::cout << std::endl;
+
+    co_await test_spin_poll();
+    std::cout << std::endl;
+
+    co_await test_pinning();
+    std::cout << std::endl;
+
+    co_await test_harvest();
+    std::cout << std::endl;
+
     std::cout << "========================================" << std::endl;
     std::cout << "   All Tests PASSED!   " << std::endl;
     std::cout << "========================================" << std::endl;
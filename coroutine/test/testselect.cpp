@@ -0,0 +1,246 @@
+#include "coroutine/channel.h"
+#include "coroutine/coroutine.h"
+#include "coroutine/cospawn.h"
+#include "coroutine/main.h"
+#include "coroutine/select.h"
+#include "coroutine/syscall.h"
+#include "coroutine/waitgroup.h"
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace utils
+{
+
+// ============================================================================
+// 测试1: 已就绪的分支立即完成，不挂起
+// ============================================================================
+auto test_ready_case() -> Coroutine<>
+{
+    std::cout << "=== Test 1: Ready Case ===" << std::endl;
+
+    Channel<int, 4> a;
+    Channel<int, 4> b;
+    co_await b.send(7);
+
+    int value = 0;
+    auto [index, state] = co_await select(recv_case(a, &value), recv_case(b, &value));
+    assert(index == 1);
+    assert(state == State::OK);
+    assert(value == 7);
+    // 没有被选中的分支不会留在等待队列里
+    co_await a.send(1);
+    assert(a.try_recv() == 1);
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试2: default 分支
+// ============================================================================
+auto test_default_case() -> Coroutine<>
+{
+    std::cout << "=== Test 2: Default Case ===" << std::endl;
+
+    Channel<int, 0> a;
+    Channel<void, 2> b;
+    int value = 0;
+    auto result = co_await select(recv_case(a, &value), default_case, send_case(b));
+    // b 有空位，发送分支就绪
+    assert(result.index == 2);
+    co_await b.send();
+    result = co_await select(recv_case(a, &value), default_case, send_case(b));
+    assert(result.index == 1);
+    assert(result.state == State::OK);
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试3: 阻塞等待，由第二个 channel 唤醒，第一个 channel 上的登记被撤销
+// ============================================================================
+auto test_blocking_select() -> Coroutine<>
+{
+    std::cout << "=== Test 3: Blocking Select ===" << std::endl;
+
+    Channel<std::string, 0> a;
+    Channel<std::string, 2> b;
+    WaitGroup wg;
+    wg.add(1);
+    auto sender = [](WaitGroup& wg, Channel<std::string, 2>& b) -> Coroutine<> {
+        auto done = DoneGuard(wg);
+        co_await delay(std::chrono::milliseconds(10));
+        auto state = co_await b.send("hello");
+        assert(state == State::OK);
+    };
+    co_spawn(sender(wg, b));
+
+    std::string value;
+    auto [index, state] = co_await select(recv_case(a, &value), recv_case(b, &value));
+    assert(index == 1);
+    assert(state == State::OK);
+    assert(value == "hello");
+    co_await wg.wait();
+
+    // a 上不再有挂起的接收者，无缓冲发送找不到对端
+    auto result = co_await select(send_case(a, std::string("lost")), default_case);
+    assert(result.index == 1);
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试4: 发送分支阻塞到有接收者
+// ============================================================================
+auto test_send_case() -> Coroutine<>
+{
+    std::cout << "=== Test 4: Send Case ===" << std::endl;
+
+    Channel<int, 0> a;
+    Channel<int, 0> b;
+    WaitGroup wg;
+    wg.add(1);
+    auto receiver = [](WaitGroup& wg, Channel<int, 0>& b) -> Coroutine<> {
+        auto done = DoneGuard(wg);
+        auto [value, state] = co_await b.recv();
+        assert(state == State::OK);
+        assert(value == 2);
+    };
+    co_spawn(receiver(wg, b));
+
+    auto [index, state] = co_await select(send_case(a, 1), send_case(b, 2));
+    assert(index == 1);
+    assert(state == State::OK);
+    co_await wg.wait();
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试5: 超时分支
+// ============================================================================
+auto test_timeout() -> Coroutine<>
+{
+    std::cout << "=== Test 5: Timeout ===" << std::endl;
+
+    Channel<int, 0> a;
+    int value = 0;
+    auto begin = std::chrono::steady_clock::now();
+    auto timeout = after(std::chrono::milliseconds(20));
+    auto [index, state] = co_await select(recv_case(a, &value), recv_case(*timeout));
+    assert(index == 1);
+    assert(state == State::OK);
+    assert(std::chrono::steady_clock::now() - begin >= std::chrono::milliseconds(20));
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试6: 关闭的 channel 使接收分支就绪
+// ============================================================================
+auto test_closed() -> Coroutine<>
+{
+    std::cout << "=== Test 6: Closed Channel ===" << std::endl;
+
+    Channel<int, 0> a;
+    Channel<int, 0> b;
+    WaitGroup wg;
+    wg.add(1);
+    auto closer = [](WaitGroup& wg, Channel<int, 0>& a) -> Coroutine<> {
+        auto done = DoneGuard(wg);
+        co_await delay(std::chrono::milliseconds(5));
+        a.close();
+    };
+    co_spawn(closer(wg, a));
+
+    int value = -1;
+    auto [index, state] = co_await select(recv_case(a, &value), recv_case(b, &value));
+    assert(index == 0);
+    assert(state == State::CLOSED);
+    assert(value == -1);
+    co_await wg.wait();
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试7: 多路汇聚，每个值恰好被收到一次
+// ============================================================================
+auto test_fan_in() -> Coroutine<>
+{
+    std::cout << "=== Test 7: Fan-in ===" << std::endl;
+
+    constexpr int items = 2000;
+    Channel<int, 0> a;
+    Channel<int, 8> b;
+    WaitGroup wg;
+    wg.add(2);
+    auto producer = []<typename C>(WaitGroup& wg, C& ch, int base) -> Coroutine<> {
+        auto done = DoneGuard(wg);
+        for (int i = 0; i < items; ++i)
+        {
+            co_await ch.send(base + i);
+        }
+    };
+    co_spawn(producer(wg, a, 0));
+    co_spawn(producer(wg, b, items));
+
+    std::vector<int> seen(2 * items, 0);
+    for (int i = 0; i < 2 * items; ++i)
+    {
+        int value = -1;
+        auto [index, state] = co_await select(recv_case(a, &value), recv_case(b, &value));
+        assert(state == State::OK);
+        assert((index == 0) == (value < items));
+        ++seen[value];
+    }
+    co_await wg.wait();
+    for (auto count : seen)
+    {
+        assert(count == 1);
+    }
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 主协程：运行所有测试
+// ============================================================================
+auto main_coro() -> MainCoroutine
+{
+    std::cout << "========================================" << std::endl;
+    std::cout << "      Select Test Suite                 " << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    co_await test_ready_case();
+    std::cout << std::endl;
+
+    co_await test_default_case();
+    std::cout << std::endl;
+
+    co_await test_blocking_select();
+    std::cout << std::endl;
+
+    co_await test_send_case();
+    std::cout << std::endl;
+
+    co_await test_timeout();
+    std::cout << std::endl;
+
+    co_await test_closed();
+    std::cout << std::endl;
+
+    co_await test_fan_in();
+    std::cout << std::endl;
+
+    std::cout << "========================================" << std::endl;
+    std::cout << "   All Tests PASSED!   " << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    co_return 0;
+}
+
+} // namespace utils
@@ -91,6 +91,7 @@ enum class StatusCode
     Forbidden = 403,
     NotFound = 404,
     MethodNotAllowed = 405,
+    InternalServerError = 500,
 };
 
 constexpr auto code_to_string(StatusCode code)
@@ -109,6 +110,7 @@ constexpr auto code_to_string(StatusCode code)
         return "404 Not Found";
     case StatusCode::MethodNotAllowed:
         return "405 Method Not Allowed";
+    case StatusCode::InternalServerError:
     case StatusCode::Unknow:
         return "500 Internal Server Error";
     }
@@ -15,6 +15,8 @@ class HttpResponse
     explicit HttpResponse() = default;
 
     auto message() -> std::string;
+    // 状态行和头部，包体通过 body 单独发送，避免拼接拷贝
+    auto head() -> std::string;
 
   public:
     Headers headers;
@@ -25,9 +27,15 @@ class HttpResponse
 };
 
 inline auto HttpResponse::message() -> std::string
+{
+    auto message = head();
+    message += body;
+    return message;
+}
+
+inline auto HttpResponse::head() -> std::string
 {
     std::string message;
-    message.clear();
     message += version_to_string(version);
     message += code_to_string(status_code);
     message += "\r\n";
@@ -52,7 +60,6 @@ inline auto HttpResponse::message() -> std::string
     }
 
     message += "\r\n";
-    message += body;
     return message;
 }
 } // namespace utils
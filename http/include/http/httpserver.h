@@ -35,6 +35,16 @@ class HttpServer
     // 中间件（可选）
     void use(HttpHandler middleware);
 
+    // 连接固定策略，转发给 TcpServer
+    void set_pin_policy(PinPolicy policy);
+    // 每个 P 一个 SO_REUSEPORT 监听 socket，转发给 TcpServer
+    void set_sharded(bool sharded);
+    // 监听 socket 与连接的 socket 选项，转发给 TcpServer
+    void set_socket_options(const SocketOptions& options);
+    // 并发连接上限与满载策略，转发给 TcpServer
+    void set_connection_limits(const ConnectionLimits& limits);
+    auto connection_stats() const -> ConnectionStats;
+
     // 启动（非阻塞）
     auto start() -> Coroutine<>;
     ~HttpServer();
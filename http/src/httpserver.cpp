@@ -1,16 +1,25 @@
 #include "http/httpserver.h"
 #include "coroutine/coroutine.h"
+#include "coroutine/file.h"
 #include "coroutine/syscall.h"
-#include "filesystem"
 #include "http/enums.h"
 #include "http/httpcontext.h"
 #include "httpparser.h"
 #include "router.h"
+#include "tcp/buffer.h"
 #include "tcp/tcpserver.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
 #include <cstddef>
+#include <fcntl.h>
+#include <linux/openat2.h>
+#include <memory>
 #include <span>
+#include <stdexcept>
 #include <string>
 #include <string_view>
+#include <unistd.h>
 namespace utils
 {
 // === HttpServer 实现 ===
@@ -48,9 +57,22 @@ void HttpServer::add_route(Method method, std::string path, HttpHandler handler)
     router_->add_route(method, std::move(path), std::move(handler));
 }
 
-auto resolve_static_file_path(std::string_view root_dir, std::string_view url_path, std::string_view url_prefix)
-    -> std::filesystem::path;
-auto get_content_type(const std::filesystem::path& path) -> std::string;
+auto resolve_static_file_path(std::string_view url_path, std::string_view url_prefix) -> std::string;
+auto get_content_type(std::string_view path) -> std::string_view;
+
+namespace
+{
+// 静态文件根目录的 O_PATH fd，随最后一份 handler 的拷贝一起关闭
+struct StaticRoot
+{
+    explicit StaticRoot(int fd) : fd(fd) {}
+    StaticRoot(const StaticRoot&) = delete;
+    StaticRoot& operator=(const StaticRoot&) = delete;
+    ~StaticRoot() { ::close(fd); }
+    int fd;
+};
+} // namespace
+
 void HttpServer::serve_static_files(std::string url_prefix, std::string root_dir)
 {
     // 确保 url_prefix 以 / 结尾
@@ -58,43 +80,53 @@ void HttpServer::serve_static_files(std::string url_prefix, std::string root_dir
     {
         url_prefix += '/';
     }
-    // 确保 root_dir 是绝对路径
-    root_dir = std::filesystem::canonical(root_dir).string();
+    // 注册时同步打开根目录一次，之后的请求都相对它异步打开，不再做阻塞的 canonical/exists
+    int root_fd = ::open(root_dir.c_str(), O_PATH | O_DIRECTORY | O_CLOEXEC);
+    if (root_fd < 0)
+    {
+        throw std::runtime_error("Failed to open static root directory");
+    }
+    auto root = std::make_shared<const StaticRoot>(root_fd);
 
-    auto handler = [root_dir, url_prefix](HttpContext* ctx) -> Coroutine<> {
+    auto handler = [root, url_prefix](HttpContext* ctx) -> Coroutine<> {
         const auto& req = ctx->request();
         auto url_path = req.path;
 
         // 1. 解析文件路径
-        auto file_path = resolve_static_file_path(root_dir, url_path, url_prefix);
+        auto file_path = resolve_static_file_path(url_path, url_prefix);
         if (file_path.empty())
         {
             ctx->response().status_code = StatusCode::Forbidden; // Forbidden (path traversal attempt)
             co_return;
         }
 
-        // 2. 检查文件是否存在
-        if (!std::filesystem::exists(file_path) || !std::filesystem::is_regular_file(file_path))
+        // 2. 异步打开，RESOLVE_BENEATH 由内核保证不会通过符号链接逃出根目录
+        auto file = co_await AsyncFile::open(file_path, O_RDONLY, 0, root->fd, RESOLVE_BENEATH);
+        if (!file.is_valid())
+        {
+            ctx->response().status_code = file.error() == -EXDEV ? StatusCode::Forbidden : StatusCode::NotFound;
+            co_return;
+        }
+        struct statx stx{};
+        if (auto res = co_await file.stat(stx); res < 0 || !S_ISREG(stx.stx_mode))
         {
+            co_await file.close();
             ctx->response().status_code = StatusCode::NotFound;
             co_return;
         }
 
-        // 3. 读取文件
-        // TODO
-        std::string content;
-        content.resize(std::filesystem::file_size(file_path));
-        auto n = co_await read(std::string_view(file_path.c_str()), content.data(), content.size());
-        if (content.empty())
+        // 3. 分块异步读取
+        auto [content, error] = co_await file.read_all();
+        co_await file.close();
+        if (error < 0)
         {
-            ctx->response().status_code = StatusCode::Unknow;
+            ctx->response().status_code = StatusCode::InternalServerError;
             co_return;
         }
 
-        // 4. 设置响应
+        // 4. 设置响应（Content-Length 由 HttpResponse::head 生成）
         ctx->response().body = std::move(content);
         ctx->response().headers.emplace("Content-Type", get_content_type(file_path));
-        ctx->response().headers.emplace("Content-Length", std::to_string(ctx->response().body.size()));
         // 可选：添加缓存头
         ctx->response().headers.emplace("Cache-Control", "public, max-age=3600");
 
@@ -104,6 +136,11 @@ void HttpServer::serve_static_files(std::string url_prefix, std::string root_dir
     // 注册通配路由：/static/*filepath
     add_route(Method::Get, url_prefix + "*", handler);
 }
+void HttpServer::set_pin_policy(PinPolicy policy) { tcp_server_->set_pin_policy(policy); }
+void HttpServer::set_sharded(bool sharded) { tcp_server_->set_sharded(sharded); }
+void HttpServer::set_socket_options(const SocketOptions& options) { tcp_server_->set_socket_options(options); }
+void HttpServer::set_connection_limits(const ConnectionLimits& limits) { tcp_server_->set_connection_limits(limits); }
+auto HttpServer::connection_stats() const -> ConnectionStats { return tcp_server_->connection_stats(); }
 void HttpServer::use(HttpHandler middleware) { router_->add_middleware(std::move(middleware)); }
 
 auto HttpServer::start() -> Coroutine<> { return tcp_server_->start(); }
@@ -118,8 +155,7 @@ bool is_safe_path(std::string_view path)
     return true;
 }
 
-auto resolve_static_file_path(std::string_view root_dir, std::string_view url_path, std::string_view url_prefix)
-    -> std::filesystem::path
+auto resolve_static_file_path(std::string_view url_path, std::string_view url_prefix) -> std::string
 {
     // 移除 url_prefix（确保匹配）
     if (url_path.size() < url_prefix.size() || url_path.substr(0, url_prefix.size()) != url_prefix)
@@ -134,45 +170,17 @@ auto resolve_static_file_path(std::string_view root_dir, std::string_view url_pa
         relative_path = relative_path.substr(1);
     }
 
-    // 安全检查
+    // 安全检查，符号链接越权由打开时的 RESOLVE_BENEATH 负责
     if (!is_safe_path(relative_path))
     {
         return {};
     }
-
-    // 拼接路径
-    std::filesystem::path full_path = std::filesystem::path(root_dir) / relative_path;
-
-    // 标准化路径（解析 . 和 ..）
-    std::error_code ec;
-    full_path = std::filesystem::canonical(full_path, ec);
-    if (ec)
-    {
-        return {}; // 文件不存在或无法访问
-    }
-
-    // 确保在 root_dir 内（防越权）
-    auto root_canon = std::filesystem::canonical(root_dir, ec);
-    if (ec)
-        return {};
-
-    // 比较字符串前缀（注意 trailing slash）
-    std::string full_str = full_path.string();
-    std::string root_str = root_canon.string();
-    if (root_str.back() != '/')
-    {
-        root_str += '/';
-    }
-    if (full_str.substr(0, root_str.size()) != root_str)
-    {
-        return {};
-    }
-
-    return full_path;
+    return std::string(relative_path);
 }
 
-std::string get_content_type(const std::filesystem::path& path)
+auto get_content_type(std::string_view path) -> std::string_view
 {
+    // headers 保存的是 string_view，返回值必须指向静态存储
     static const std::unordered_map<std::string, std::string> types = {
         {".html", "text/html"}, {".css", "text/css"},   {".js", "application/javascript"},
         {".png", "image/png"},  {".jpg", "image/jpeg"}, {".json", "application/json"},
@@ -180,41 +188,62 @@ std::string get_content_type(const std::filesystem::path& path)
         // ... 其他类型
     };
 
-    std::string ext = path.extension().string();
+    auto dot = path.rfind('.');
+    auto slash = path.rfind('/');
+    if (dot == std::string_view::npos || (slash != std::string_view::npos && dot < slash))
+    {
+        return "application/octet-stream";
+    }
+    std::string ext(path.substr(dot));
     std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return std::tolower(c); });
 
     auto it = types.find(ext);
-    return (it != types.end()) ? it->second : "application/octet-stream";
+    return (it != types.end()) ? std::string_view(it->second) : "application/octet-stream";
 }
 
 auto HttpServer::handle_http_connection(Socket tcp_conn) -> Coroutine<>
 {
-    constexpr size_t buffer_size = 4096;
     HttpContext ctx;
     HttpParser parser;
-    // 核心修改 1：引入连接级别的累积缓冲区
-    std::vector<char> buffer;
+    // 连接级别的缓冲区，由当前 P 池中的段组成，请求处理完立即归还
+    Buffer buffer;
     while (true)
     {
-        // 1. 动态准备可写空间（直接在尾部预留 4096 字节）
-        size_t old_size = buffer.size();
-        buffer.resize(old_size + 4096);
-
-        // 2. 直接读到 vector 的尾部空闲区域！完全没有 temp_buffer 的拷贝！
-        auto n = co_await tcp_conn.recv(buffer.data() + old_size, 4096);
+        // 1. 直接读到段的空闲区域，解析器要求请求在一段之内
+        auto span = buffer.writable_span(BufferSegment::Size);
+        int n = -EAGAIN;
+        if (buffer.empty())
+        {
+            // 2. 请求边界上先非阻塞地读；没有数据时归还段再等待可读，空闲的 keep-alive 连接不持有缓冲区
+            n = tcp_conn.try_recv(span);
+            if (n == -EAGAIN)
+            {
+                buffer.clear();
+                if (co_await tcp_conn.wait_readable() < 0)
+                {
+                    break;
+                }
+                span = buffer.writable_span(BufferSegment::Size);
+                n = tcp_conn.try_recv(span);
+            }
+        }
+        if (n == -EAGAIN)
+        {
+            n = co_await tcp_conn.recv(span);
+        }
 
         if (n <= 0)
         {
             break; // 客户端断开或出错
         }
 
-        // 3. 截断多余的预留空间，让 vector 的 size 变成实际有效数据的总长度
-        buffer.resize(old_size + n);
+        // 3. 推进写位置，buffer 中只有实际读到的数据
+        buffer.commit_write(n);
 
         // 4. 开始解析 (直接拿 buffer 开刀)
         while (!buffer.empty())
         {
-            auto result = parser.parse({buffer.data(), buffer.size()}, ctx.request());
+            auto result = parser.parse(buffer.front(), ctx.request());
 
             if (result == HttpParser::ParseResult::error)
             {
@@ -243,11 +272,16 @@ auto HttpServer::handle_http_connection(Socket tcp_conn) -> Coroutine<>
                 ctx.set_middlewares(std::move(middlewares));
 
                 co_await ctx.run();
-                co_await tcp_conn.send(ctx.response().message());
+                auto& response = ctx.response();
+                auto head = response.head();
+                std::array<iovec, 2> iov{{{head.data(), head.size()}, {response.body.data(), response.body.size()}}};
+                co_await tcp_conn.writev(iov);
             }
-            buffer.clear();
+            // request 的头部指向 buffer 中的段，必须在归还段之前读取
+            bool keep_alive = ctx.request().is_keep_alive();
+            buffer.retrieve(buffer.readable_bytes());
 
-            if (!ctx.request().is_keep_alive())
+            if (!keep_alive)
             {
                 break;
             }
@@ -1,10 +1,12 @@
 #pragma once
 #include <algorithm>
+#include <array>
 #include <cstdint>
 #include <endian.h> // Linux 下用于网络字节序转换: be32toh, be64toh
 #include <span>
 #include <string>
 #include <string_view>
+#include <sys/uio.h>
 #include <vector>
 namespace utils
 {
@@ -64,6 +66,11 @@ class RpcMessage
     std::string payload;
     RpcMessage() = default;
     auto string() { return std::string(reinterpret_cast<const char*>(&header), sizeof(RpcHeader)) + method + payload; }
+    // 供 writev 使用：头部、method、payload 分别指向各自的内存，不拼接
+    auto iovecs() -> std::array<iovec, 3>
+    {
+        return {{{&header, sizeof(RpcHeader)}, {method.data(), method.size()}, {payload.data(), payload.size()}}};
+    }
 };
 
 // 3. 解析器状态机返回值
@@ -4,6 +4,7 @@
 #include "coroutine/waitgroup.h"
 #include "rpc/message.h"
 #include "tcp/socket.h"
+#include "tcp/socketoptions.h"
 #include <cstddef>
 #include <iostream>
 #include <ostream>
@@ -14,8 +15,16 @@ namespace utils
 class RpcClient
 {
   public:
-    RpcClient(std::string_view host, uint16_t port) : socket_(Socket::create_tcp()), server_addr_(port, host)
+    RpcClient(std::string_view host, uint16_t port, const SocketOptions& options = SocketOptions::low_latency())
+        : RpcClient(InetAddress(port, host), options)
     {
+    }
+    // 服务端在同一主机时可以用 InetAddress::unix_path 走 Unix 域 socket，绕过 TCP 协议栈
+    explicit RpcClient(const InetAddress& addr, const SocketOptions& options = SocketOptions::low_latency())
+        : socket_(Socket::create_stream(addr.family())), server_addr_(addr)
+    {
+        // 默认关闭 Nagle，小请求不会被延迟 ACK 卡住
+        options.apply_client(socket_.fd());
         wg_.add(2); // 读写协程
         co_spawn(write_worker());
         co_spawn(read_worker());
@@ -96,7 +105,8 @@ class RpcClient
     std::atomic<bool> is_closed_{false};
     std::atomic<bool> is_connected_ = false;
     WaitGroup wg_;
-    Channel<RpcRequest, Capacity> pending_;
+    // 容量在运行时指定，空闲的客户端不为 1024 个请求预留存储
+    Channel<RpcRequest, DynamicCapacity> pending_{Capacity};
     std::unordered_map<uint64_t, ReadyAwaiter*> awaiters_;
     std::unordered_map<uint64_t, RpcResponse> responses_;
     std::atomic<size_t> sequence_id_ = 0;
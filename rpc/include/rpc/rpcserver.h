@@ -4,7 +4,9 @@
 #include "coroutine/coroutine.h"
 #include "coroutine/mutex.h"
 #include "rpc/message.h"
+#include "tcp/session.h"
 #include "tcp/socket.h"
+#include "tcp/socketoptions.h"
 #include "tcp/tcpserver.h"
 #include <functional>
 #include <map>
@@ -19,8 +21,19 @@ class RpcServer
 {
   public:
     RpcServer(std::string_view listen_ip, uint16_t port);
+    // 可以监听 IPv6 或 Unix 域路径（InetAddress::unix_path）
+    explicit RpcServer(const InetAddress& addr);
     ~RpcServer();
     auto start() -> Coroutine<>;
+    // 默认 SocketOptions::low_latency()，在 start 之前调用
+    void set_socket_options(const SocketOptions& options);
+    // 并发连接上限与满载策略，在 start 之前调用
+    void set_connection_limits(const ConnectionLimits& limits);
+    auto connection_stats() const -> ConnectionStats;
+    // 每个连接发送队列的字节水位，在 start 之前调用
+    void set_send_queue_limits(const SendQueueLimits& limits);
+    // 响应写合并的统计，汇总所有连接
+    auto write_stats() const -> WriteBatchStats;
 
     template <typename F> void register_service(std::string method, F func);
 
@@ -4,6 +4,7 @@
 #include "coroutine/waitgroup.h"
 #include "rpcparser.h"
 #include "tcp/buffer.h"
+#include <array>
 #include <cassert>
 #include <endian.h>
 #include <iostream>
@@ -37,8 +38,8 @@ auto RpcClient::write_worker() -> Coroutine<>
         msg.method = std::move(req.method);
         msg.payload = std::move(req.payload);
 
-        auto str = msg.string();
-        auto count = co_await socket_.send(str);
+        auto iov = msg.iovecs();
+        auto count = co_await socket_.writev(iov);
         if (count <= 0)
         {
             break;
@@ -57,6 +58,8 @@ auto RpcClient::read_worker() -> Coroutine<>
     }
     constexpr size_t MinReadSize = 1024;
     Buffer buffer;
+    // 单次 readv 最多覆盖的段数
+    std::array<iovec, 16> iovs;
     RpcParser parser;
     RpcMessage msg;
 
@@ -64,7 +67,7 @@ auto RpcClient::read_worker() -> Coroutine<>
     {
         // 1. 核心优化：动态计算还需要读多少数据
         size_t expected_bytes = parser.get_expected_bytes();
-        size_t readable_bytes = buffer.readable_span().size();
+        size_t readable_bytes = buffer.readable_bytes();
 
         // 缺少的字节数 = 期望字节数 - 当前已有字节数
         size_t need_bytes = 0;
@@ -78,9 +81,10 @@ auto RpcClient::read_worker() -> Coroutine<>
         // - 如果解析出 Header 发现是个 10MB 的大包，这里直接变成读 10MB
         size_t bytes_to_read = std::max(MinReadSize, need_bytes);
 
-        // 2. 告诉 Buffer：“给我确切准备好 bytes_to_read 大小的连续内存写空间”
-        // 这里会触发底层 vector 或内存池的动态扩容
-        auto n = co_await socket_.recv(buffer.writable_span(bytes_to_read));
+        // 2. 告诉 Buffer：“给我准备好 bytes_to_read 大小的写空间”
+        // 空间由若干个池化的段组成，一次 readv 读入，已有数据不会被移动
+        auto count = buffer.writable_iovecs(iovs, bytes_to_read);
+        auto n = co_await socket_.readv({iovs.data(), count});
         if (n <= 0)
         {
             break; // 对端关闭或出错
@@ -90,7 +94,7 @@ auto RpcClient::read_worker() -> Coroutine<>
         // 2. 循环丢给 Parser 切包
         while (!buffer.empty())
         {
-            auto result = parser.parse(buffer.readable_span(), msg);
+            auto result = parser.parse(buffer, msg);
 
             if (result == RpcParseResult::Error)
             {
@@ -1,5 +1,6 @@
 #pragma once
 #include "rpc/common.h"
+#include "tcp/buffer.h"
 #include <cstddef>
 #include <cstdint>
 #include <span>
@@ -50,28 +51,31 @@ class RpcParser
         body_len_ = 0;
     }
 
-    RpcParseResult parse(std::span<char> buffer, RpcMessage& out_msg)
+    // buffer 中的数据可能跨越多个段，解析时直接从各段拷贝到消息对象，不需要先拼成连续内存
+    RpcParseResult parse(const Buffer& buffer, RpcMessage& out_msg)
     {
         consumed_bytes_ = 0;
+        size_t readable = buffer.readable_bytes();
 
         // --- 阶段 1：解析并填充 Header ---
         if (state_ == State::ExpectHeader)
         {
-            if (buffer.size() < sizeof(RpcHeader))
+            if (readable < sizeof(RpcHeader))
             {
                 return RpcParseResult::Incomplete;
             }
 
-            const RpcHeader* raw_header = reinterpret_cast<const RpcHeader*>(buffer.data());
+            RpcHeader raw_header;
+            buffer.copy_to(0, &raw_header, sizeof(RpcHeader));
 
             // 1. 校验魔数
-            if (raw_header->get_magic() != RpcHeader::EXPECTED_MAGIC)
+            if (raw_header.get_magic() != RpcHeader::EXPECTED_MAGIC)
             {
                 return RpcParseResult::Error;
             }
 
             // 2. 直接写入目标对象 out_msg
-            out_msg.header = *raw_header;
+            out_msg.header = raw_header;
             method_len_ = out_msg.header.get_method_length();
             body_len_ = out_msg.header.get_body_length();
 
@@ -89,19 +93,19 @@ class RpcParser
         {
             size_t total_packet_size = sizeof(RpcHeader) + method_len_ + body_len_;
 
-            if (buffer.size() < total_packet_size)
+            if (readable < total_packet_size)
             {
                 // 虽然 Header 已经填进去了，但数据没够，告诉外部还需要更多数据
                 return RpcParseResult::Incomplete;
             }
 
             // 4. 解析 Method (Payload 1)
-            const char* method_ptr = buffer.data() + sizeof(RpcHeader);
-            out_msg.method.assign(method_ptr, method_len_);
+            out_msg.method.clear();
+            buffer.append_to(sizeof(RpcHeader), method_len_, out_msg.method);
 
             // 5. 解析 Body (Payload 2)
-            const char* body_ptr = method_ptr + method_len_;
-            out_msg.payload.assign(body_ptr, body_len_);
+            out_msg.payload.clear();
+            buffer.append_to(sizeof(RpcHeader) + method_len_, body_len_, out_msg.payload);
 
             consumed_bytes_ = total_packet_size;
 
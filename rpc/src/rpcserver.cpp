@@ -8,6 +8,7 @@
 #include <algorithm>
 #include <array>
 #include <cassert>
+#include <cerrno>
 #include <cstdint>
 #include <iostream>
 #include <memory>
@@ -25,12 +26,15 @@ struct RpcServer::Impl
 {
     TcpServer tcp_server_;
     std::unordered_map<std::string, std::function<std::string(std::string)>> services_;
+    std::shared_ptr<WriteBatchCounter> write_counter_ = std::make_shared<WriteBatchCounter>();
+    SendQueueLimits send_queue_limits_{};
 
-    Impl(std::string_view listen_ip, uint16_t port) : tcp_server_(InetAddress{port, listen_ip})
+    Impl(const InetAddress& addr) : tcp_server_(addr)
     {
+        tcp_server_.set_socket_options(SocketOptions::low_latency());
         // 只需用一个极简的 lambda 转发给 Impl 的成员函数即可
         tcp_server_.set_connection_handler([this](Socket connection) -> Coroutine<> {
-            return this->handle_connection(std::make_shared<RpcSession>(std::move(connection)));
+            return this->handle_connection(std::make_shared<RpcSession>(std::move(connection), write_counter_, send_queue_limits_));
         });
     }
 
@@ -43,6 +47,8 @@ struct RpcServer::Impl
         constexpr size_t MinReadSize = 1024;
 
         Buffer buffer;
+        // 单次 readv 最多覆盖的段数
+        std::array<iovec, 16> iovs;
         RpcParser parser;
         RpcMessage msg;
 
@@ -50,7 +56,7 @@ struct RpcServer::Impl
         {
             // 1. 核心优化：动态计算还需要读多少数据
             size_t expected_bytes = parser.get_expected_bytes();
-            size_t readable_bytes = buffer.readable_span().size();
+            size_t readable_bytes = buffer.readable_bytes();
 
             // 缺少的字节数 = 期望字节数 - 当前已有字节数
             size_t need_bytes = 0;
@@ -64,9 +70,30 @@ struct RpcServer::Impl
             // - 如果解析出 Header 发现是个 10MB 的大包，这里直接变成读 10MB
             size_t bytes_to_read = std::max(MinReadSize, need_bytes);
 
-            // 2. 告诉 Buffer：“给我确切准备好 bytes_to_read 大小的连续内存写空间”
-            // 这里会触发底层 vector 或内存池的动态扩容
-            auto n = co_await session->recv(buffer.writable_span(bytes_to_read));
+            // 2. 告诉 Buffer：“给我准备好 bytes_to_read 大小的写空间”
+            // 空间由若干个池化的段组成，一次 readv 读入，已有数据不会被移动
+            auto count = buffer.writable_iovecs(iovs, bytes_to_read);
+            int n = -EAGAIN;
+            if (buffer.empty())
+            {
+                // 处在消息边界时先非阻塞地读，数据已经到达就不经过 ring
+                // 没有数据则归还段再等待可读，空闲连接不持有缓冲区；可读后再非阻塞读一次，只占一次 ring 操作
+                n = session->try_readv({iovs.data(), count});
+                if (n == -EAGAIN)
+                {
+                    buffer.clear();
+                    if (co_await session->wait_readable() < 0)
+                    {
+                        break;
+                    }
+                    count = buffer.writable_iovecs(iovs, bytes_to_read);
+                    n = session->try_readv({iovs.data(), count});
+                }
+            }
+            if (n == -EAGAIN)
+            {
+                n = co_await session->readv({iovs.data(), count});
+            }
             if (n <= 0)
             {
                 std::cout << "connection closed" << std::endl;
@@ -77,7 +104,7 @@ struct RpcServer::Impl
             // 3. 循环解析
             while (!buffer.empty())
             {
-                auto result = parser.parse(buffer.readable_span(), msg);
+                auto result = parser.parse(buffer, msg);
 
                 if (result == RpcParseResult::Error)
                 {
@@ -129,7 +156,8 @@ struct RpcServer::Impl
 };
 
 // 2. RpcServer 构造函数：变得非常清爽
-RpcServer::RpcServer(std::string_view listen_ip, uint16_t port) : impl_(std::make_unique<Impl>(listen_ip, port)) {}
+RpcServer::RpcServer(std::string_view listen_ip, uint16_t port) : RpcServer(InetAddress{port, listen_ip}) {}
+RpcServer::RpcServer(const InetAddress& addr) : impl_(std::make_unique<Impl>(addr)) {}
 
 // 3. 析构与移动语义实现
 RpcServer::~RpcServer() = default;
@@ -137,6 +165,15 @@ RpcServer::~RpcServer() = default;
 // 4. 委托方法调用
 auto RpcServer::start() -> Coroutine<> { return impl_->tcp_server_.start(); }
 
+void RpcServer::set_socket_options(const SocketOptions& options) { impl_->tcp_server_.set_socket_options(options); }
+void RpcServer::set_connection_limits(const ConnectionLimits& limits)
+{
+    impl_->tcp_server_.set_connection_limits(limits);
+}
+auto RpcServer::connection_stats() const -> ConnectionStats { return impl_->tcp_server_.connection_stats(); }
+void RpcServer::set_send_queue_limits(const SendQueueLimits& limits) { impl_->send_queue_limits_ = limits; }
+auto RpcServer::write_stats() const -> WriteBatchStats { return impl_->write_counter_->stats(); }
+
 void RpcServer::register_service_impl(std::string method, std::function<std::string(std::string)> func)
 {
     impl_->services_.emplace(std::move(method), std::move(func));
@@ -0,0 +1,234 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 框架相关头文件
+#include "coroutine/coroutine.h"
+#include "coroutine/iostats.h"
+#include "coroutine/main.h"
+#include "coroutine/syscall.h"
+#include "coroutine/waitgroup.h"
+#include "rpc/rpcclient.h"
+#include "rpc/rpcserver.h"
+#include "service.pb.h"
+#include "tcp/inetaddress.h"
+#include "tcp/socket.h"
+#include "tcp/tcpserver.h"
+
+// 同一进程内跑服务端和客户端，比较两种 IO 后端在 echo 和 RPC 负载下的表现
+// 分别运行：
+//   COROUTINE_IO_BACKEND=uring ./backendbench
+//   COROUTINE_IO_BACKEND=epoll ./backendbench
+
+using namespace std::chrono;
+
+namespace utils
+{
+
+constexpr uint16_t echo_port = 9100;
+constexpr uint16_t rpc_port = 9101;
+
+// --- 结果收集器 ---
+struct BenchResult
+{
+    std::mutex mtx;
+    std::vector<double> latencies; // 微秒单位
+    std::atomic<size_t> fail_count{0};
+
+    void merge(std::vector<double>& local_latencies, size_t fail)
+    {
+        fail_count += fail;
+        std::lock_guard<std::mutex> lock(mtx);
+        latencies.insert(latencies.end(), local_latencies.begin(), local_latencies.end());
+    }
+};
+
+void print_report(const char* workload, size_t size_bytes, int conc, double duration_s, BenchResult& res)
+{
+    if (res.latencies.empty())
+    {
+        return;
+    }
+    std::sort(res.latencies.begin(), res.latencies.end());
+    double qps = res.latencies.size() / duration_s;
+    double p50 = res.latencies[res.latencies.size() / 2];
+    double p99 = res.latencies[static_cast<size_t>(res.latencies.size() * 0.99)];
+
+    std::cout << std::left << std::setw(8) << workload << std::right << std::setw(8) << size_bytes << std::setw(8)
+              << conc << std::setw(12) << std::fixed << std::setprecision(1) << qps << std::setw(10) << p50
+              << std::setw(10) << p99 << std::setw(8) << res.fail_count.load() << std::endl;
+}
+
+// --- echo 负载 ---
+auto echo_handler(Socket conn) -> Coroutine<>
+{
+    std::array<char, 16384> buffer;
+    while (true)
+    {
+        auto n = co_await conn.recv(buffer);
+        if (n <= 0)
+        {
+            co_return;
+        }
+        if (co_await conn.send({buffer.data(), static_cast<size_t>(n)}) != n)
+        {
+            co_return;
+        }
+    }
+}
+
+auto echo_session(int requests, const std::string& payload, BenchResult& result, WaitGroup& wg) -> Coroutine<>
+{
+    DoneGuard guard(wg);
+    std::vector<double> local_latencies;
+    local_latencies.reserve(requests);
+    size_t fail = 0;
+
+    auto socket = Socket::create_tcp();
+    if (co_await socket.connect(InetAddress(echo_port, "127.0.0.1")) < 0)
+    {
+        result.merge(local_latencies, requests);
+        co_return;
+    }
+    std::string reply(payload.size(), '\0');
+    for (int i = 0; i < requests; ++i)
+    {
+        auto start = steady_clock::now();
+        if (co_await socket.send(payload) != static_cast<ssize_t>(payload.size()))
+        {
+            ++fail;
+            break;
+        }
+        size_t received = 0;
+        while (received < reply.size())
+        {
+            auto n = co_await socket.recv({reply.data() + received, reply.size() - received});
+            if (n <= 0)
+            {
+                break;
+            }
+            received += n;
+        }
+        if (received != reply.size())
+        {
+            ++fail;
+            break;
+        }
+        local_latencies.push_back(duration_cast<nanoseconds>(steady_clock::now() - start).count() / 1000.0);
+    }
+    result.merge(local_latencies, fail);
+}
+
+// --- RPC 负载 ---
+inline auto echo(::rpc::EchoRequest msg) -> ::rpc::EchoResponse
+{
+    ::rpc::EchoResponse res;
+    res.set_data(std::move(msg.data()));
+    return res;
+}
+
+auto rpc_session(RpcClient& client, int requests, const std::string& payload, BenchResult& result, WaitGroup& wg)
+    -> Coroutine<>
+{
+    DoneGuard guard(wg);
+    std::vector<double> local_latencies;
+    local_latencies.reserve(requests);
+    size_t fail = 0;
+
+    rpc::EchoRequest req;
+    req.set_data(payload);
+    for (int i = 0; i < requests; ++i)
+    {
+        rpc::EchoResponse res;
+        auto start = steady_clock::now();
+        if (co_await client.call("echo", req, res))
+        {
+            local_latencies.push_back(duration_cast<nanoseconds>(steady_clock::now() - start).count() / 1000.0);
+        }
+        else
+        {
+            ++fail;
+        }
+    }
+    result.merge(local_latencies, fail);
+}
+
+auto main_coro() -> MainCoroutine
+{
+    std::vector<size_t> payload_sizes = {64, 4096};
+    std::vector<int> concurrency_levels = {1, 16, 128};
+    const int TEST_SAMPLES = 20000;
+
+    TcpServer echo_server(InetAddress(echo_port, "127.0.0.1"));
+    echo_server.set_connection_handler(echo_handler);
+    co_spawn(echo_server.start());
+
+    RpcServer rpc_server("127.0.0.1", rpc_port);
+    rpc_server.register_service("echo", echo);
+    co_spawn(rpc_server.start());
+    // 等待两个服务端开始监听
+    co_await delay(milliseconds(100));
+
+    RpcClient client("127.0.0.1", rpc_port);
+
+    std::cout << "IO backend: " << (io_backend() == IoBackend::URING ? "io_uring" : "epoll") << std::endl;
+    std::cout << std::string(64, '=') << std::endl;
+    std::cout << std::left << std::setw(8) << "Load" << std::right << std::setw(8) << "Size(B)" << std::setw(8)
+              << "Conc" << std::setw(12) << "QPS" << std::setw(10) << "P50(us)" << std::setw(10) << "P99(us)"
+              << std::setw(8) << "Fail" << std::endl;
+    std::cout << std::string(64, '-') << std::endl;
+
+    for (const char* workload : {"echo", "rpc"})
+    {
+        bool is_echo = std::string_view(workload) == "echo";
+        for (size_t size : payload_sizes)
+        {
+            std::string payload(size, 'x');
+            for (int conc : concurrency_levels)
+            {
+                BenchResult result;
+                result.latencies.reserve(TEST_SAMPLES);
+                WaitGroup wg;
+                int req_per_coro = TEST_SAMPLES / conc;
+
+                auto start_time = steady_clock::now();
+                wg.add(conc);
+                for (int i = 0; i < conc; ++i)
+                {
+                    if (is_echo)
+                    {
+                        co_spawn(echo_session(req_per_coro, payload, result, wg));
+                    }
+                    else
+                    {
+                        co_spawn(rpc_session(client, req_per_coro, payload, result, wg));
+                    }
+                }
+                co_await wg.wait();
+                double duration_s = duration_cast<microseconds>(steady_clock::now() - start_time).count() / 1e6;
+
+                print_report(workload, size, conc, duration_s, result);
+            }
+        }
+        std::cout << std::string(64, '-') << std::endl;
+    }
+    // 服务端响应的写合并情况：并发越高，单次 writev 合并的响应越多
+    auto write_stats = rpc_server.write_stats();
+    std::cout << "rpc responses per writev: " << std::fixed << std::setprecision(2)
+              << write_stats.messages_per_write() << ", histogram:";
+    for (auto count : write_stats.batch_histogram)
+    {
+        std::cout << ' ' << count;
+    }
+    std::cout << std::endl;
+    co_await client.join();
+    co_return 0;
+}
+
+} // namespace utils
@@ -0,0 +1,230 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// 框架相关头文件
+#include "coroutine/coroutine.h"
+#include "coroutine/main.h"
+#include "coroutine/syscall.h"
+#include "coroutine/waitgroup.h"
+#include "rpc/rpcclient.h"
+#include "rpc/rpcserver.h"
+#include "service.pb.h"
+#include "tcp/inetaddress.h"
+#include "tcp/socket.h"
+#include "tcp/tcpserver.h"
+
+// 同一主机上比较回环 TCP 与 Unix 域 socket 的往返延迟：
+// 原始 ping-pong 和 RPC echo 各测一遍
+
+using namespace std::chrono;
+
+namespace utils
+{
+
+struct LatencyResult
+{
+    std::mutex mtx;
+    std::vector<double> latencies; // 微秒单位
+    std::atomic<size_t> fail_count{0};
+
+    void merge(std::vector<double>& local_latencies, size_t fail)
+    {
+        fail_count += fail;
+        std::lock_guard<std::mutex> lock(mtx);
+        latencies.insert(latencies.end(), local_latencies.begin(), local_latencies.end());
+    }
+};
+
+void print_report(const char* workload, const char* transport, int conc, LatencyResult& res)
+{
+    if (res.latencies.empty())
+    {
+        return;
+    }
+    std::sort(res.latencies.begin(), res.latencies.end());
+    auto at = [&](double q) { return res.latencies[static_cast<size_t>(res.latencies.size() * q)]; };
+
+    std::cout << std::left << std::setw(8) << workload << std::setw(8) << transport << std::right << std::setw(6)
+              << conc << std::fixed << std::setprecision(1) << std::setw(10) << at(0.5) << std::setw(10) << at(0.99)
+              << std::setw(10) << at(0.999) << std::setw(8) << res.fail_count.load() << std::endl;
+}
+
+// --- 原始 ping-pong ---
+auto pong_handler(Socket conn) -> Coroutine<>
+{
+    std::array<char, 4096> buffer;
+    while (true)
+    {
+        auto n = co_await conn.recv(buffer);
+        if (n <= 0 || co_await conn.send({buffer.data(), static_cast<size_t>(n)}) != n)
+        {
+            co_return;
+        }
+    }
+}
+
+auto ping_session(InetAddress addr, int requests, size_t size, LatencyResult& result, WaitGroup& wg) -> Coroutine<>
+{
+    DoneGuard guard(wg);
+    std::vector<double> local_latencies;
+    local_latencies.reserve(requests);
+    size_t fail = 0;
+
+    auto socket = Socket::create_stream(addr.family());
+    if (co_await socket.connect(addr) < 0)
+    {
+        result.merge(local_latencies, requests);
+        co_return;
+    }
+    std::string payload(size, 'x');
+    std::string reply(size, '\0');
+    for (int i = 0; i < requests; ++i)
+    {
+        auto start = steady_clock::now();
+        if (co_await socket.send(payload) != static_cast<ssize_t>(size))
+        {
+            ++fail;
+            break;
+        }
+        size_t received = 0;
+        while (received < size)
+        {
+            auto n = co_await socket.recv({reply.data() + received, size - received});
+            if (n <= 0)
+            {
+                break;
+            }
+            received += n;
+        }
+        if (received != size)
+        {
+            ++fail;
+            break;
+        }
+        local_latencies.push_back(duration_cast<nanoseconds>(steady_clock::now() - start).count() / 1000.0);
+    }
+    result.merge(local_latencies, fail);
+}
+
+// --- RPC echo ---
+inline auto echo(::rpc::EchoRequest msg) -> ::rpc::EchoResponse
+{
+    ::rpc::EchoResponse res;
+    res.set_data(std::move(msg.data()));
+    return res;
+}
+
+auto rpc_session(RpcClient& client, int requests, size_t size, LatencyResult& result, WaitGroup& wg) -> Coroutine<>
+{
+    DoneGuard guard(wg);
+    std::vector<double> local_latencies;
+    local_latencies.reserve(requests);
+    size_t fail = 0;
+
+    rpc::EchoRequest req;
+    req.set_data(std::string(size, 'x'));
+    for (int i = 0; i < requests; ++i)
+    {
+        rpc::EchoResponse res;
+        auto start = steady_clock::now();
+        if (co_await client.call("echo", req, res))
+        {
+            local_latencies.push_back(duration_cast<nanoseconds>(steady_clock::now() - start).count() / 1000.0);
+        }
+        else
+        {
+            ++fail;
+        }
+    }
+    result.merge(local_latencies, fail);
+}
+
+auto main_coro() -> MainCoroutine
+{
+    constexpr size_t payload_size = 128;
+    const int TEST_SAMPLES = 20000;
+    std::vector<int> concurrency_levels = {1, 16};
+
+    struct Transport
+    {
+        const char* name;
+        InetAddress ping_addr;
+        InetAddress rpc_addr;
+    };
+    std::vector<Transport> transports = {
+        {"tcp", InetAddress(9300, "127.0.0.1"), InetAddress(9301, "127.0.0.1")},
+        // 抽象命名空间，不会在文件系统上留下 socket 文件
+        {"uds", InetAddress::unix_path("@transportbench.ping"), InetAddress::unix_path("@transportbench.rpc")},
+    };
+
+    std::vector<std::unique_ptr<TcpServer>> ping_servers;
+    std::vector<std::unique_ptr<RpcServer>> rpc_servers;
+    std::vector<std::unique_ptr<RpcClient>> clients;
+    for (auto& transport : transports)
+    {
+        auto& ping_server = ping_servers.emplace_back(std::make_unique<TcpServer>(transport.ping_addr));
+        ping_server->set_connection_handler(pong_handler);
+        co_spawn(ping_server->start());
+
+        auto& rpc_server = rpc_servers.emplace_back(std::make_unique<RpcServer>(transport.rpc_addr));
+        rpc_server->register_service("echo", echo);
+        co_spawn(rpc_server->start());
+    }
+    // 等待服务端开始监听
+    co_await delay(milliseconds(100));
+    for (auto& transport : transports)
+    {
+        clients.emplace_back(std::make_unique<RpcClient>(transport.rpc_addr));
+    }
+
+    std::cout << "Round-trip latency, payload " << payload_size << "B" << std::endl;
+    std::cout << std::string(60, '=') << std::endl;
+    std::cout << std::left << std::setw(8) << "Load" << std::setw(8) << "Trans" << std::right << std::setw(6) << "Conc"
+              << std::setw(10) << "P50(us)" << std::setw(10) << "P99(us)" << std::setw(10) << "P999(us)" << std::setw(8)
+              << "Fail" << std::endl;
+    std::cout << std::string(60, '-') << std::endl;
+
+    for (const char* workload : {"ping", "rpc"})
+    {
+        bool is_ping = std::string_view(workload) == "ping";
+        for (int conc : concurrency_levels)
+        {
+            for (size_t t = 0; t < transports.size(); ++t)
+            {
+                LatencyResult result;
+                result.latencies.reserve(TEST_SAMPLES);
+                WaitGroup wg;
+                wg.add(conc);
+                for (int i = 0; i < conc; ++i)
+                {
+                    if (is_ping)
+                    {
+                        co_spawn(ping_session(transports[t].ping_addr, TEST_SAMPLES / conc, payload_size, result, wg));
+                    }
+                    else
+                    {
+                        co_spawn(rpc_session(*clients[t], TEST_SAMPLES / conc, payload_size, result, wg));
+                    }
+                }
+                co_await wg.wait();
+                print_report(workload, transports[t].name, conc, result);
+            }
+        }
+        std::cout << std::string(60, '-') << std::endl;
+    }
+    for (auto& client : clients)
+    {
+        co_await client->join();
+    }
+    co_return 0;
+}
+
+} // namespace utils
@@ -1,72 +1,459 @@
 #pragma once
+#include "coroutine/coroutine.h"
+#include "coroutine/cospawn.h"
+#include "coroutine/syscall.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
 #include <span>
+#include <string>
+#include <utility>
 #include <vector>
+#include <sys/uio.h>
 
-class Buffer
+// 固定大小的缓冲区段，内容不做初始化
+struct BufferSegment
+{
+    static constexpr size_t Size = 16 * 1024;
+    BufferSegment* next;
+    char data[Size];
+};
+
+// 单个 P 的段缓存统计
+struct SegmentPoolStats
+{
+    // 当前缓存的空闲段数
+    size_t cached = 0;
+    // 在本 P 上借出、归还的段数；段可能在另一个 P 上归还，汇总所有 P 后差值才是借出中的段数
+    uint64_t acquired = 0;
+    uint64_t released = 0;
+    // 向系统申请、释放的段数
+    uint64_t allocated = 0;
+    uint64_t freed = 0;
+};
+
+// 每个 P 一份的空闲段缓存：只由该 P 的线程访问，不需要加锁
+// 缓存中闲置超过一个回收周期的段释放给系统，突发流量过后内存占用会回落；
+// P 空闲后不再借还段，由固定在该 P 上的定时协程继续回收，直到缓存清空
+class SegmentPool
 {
   public:
-    explicit Buffer(size_t initial_size = 1024) : buffer_(initial_size), read_idx_(0), write_idx_(0) {}
+    using Clock = std::chrono::steady_clock;
 
-    // 获取可供 Parser 读取的数据视图 (std::span)
-    std::span<char> readable_span() { return {buffer_.data() + read_idx_, readable_bytes()}; }
+    static BufferSegment* acquire()
+    {
+        auto [cache, lock] = local();
+        return cache.acquire();
+    }
 
-    // Parser 吃掉数据后，只移动 read_idx，不产生内存拷贝！
-    void retrieve(size_t bytes)
+    static void release(BufferSegment* segment)
+    {
+        auto [cache, lock] = local();
+        cache.release(segment);
+        if (auto id = utils::current_processor(); id >= 0 && cache.count > 0 && !cache.trimming)
+        {
+            cache.trimming = true;
+            utils::co_spawn_pinned(trim_loop(id), id);
+        }
+    }
+
+    // 每个 P 最多缓存的空闲段数，超出的直接释放
+    static void set_max_cached(size_t count) { max_cached_.store(count, std::memory_order_relaxed); }
+    // 回收周期：整个周期内都没有被用到的缓存段在周期结束时释放
+    static void set_idle_release(std::chrono::milliseconds period)
+    {
+        idle_release_.store(period.count(), std::memory_order_relaxed);
+    }
+
+    // 按 P 编号排列，最后一项是调度器以外的线程共用的缓存
+    static auto stats() -> std::vector<SegmentPoolStats>
     {
-        if (bytes < readable_bytes())
+        std::vector<SegmentPoolStats> stats;
+        stats.reserve(utils::processor_count() + 1);
+        for (size_t i = 0; i <= utils::processor_count(); ++i)
         {
-            read_idx_ += bytes;
+            stats.push_back(caches()[i].stats());
         }
-        else
+        return stats;
+    }
+    // 借出中的段数
+    static auto in_use() -> int64_t
+    {
+        int64_t count = 0;
+        for (const auto& stat : stats())
         {
-            // 数据全吃光了，重置指针，这也是一种零拷贝优化
-            read_idx_ = 0;
-            write_idx_ = 0;
+            count += static_cast<int64_t>(stat.acquired) - static_cast<int64_t>(stat.released);
         }
+        return count;
     }
 
-    // 准备从 Socket 读数据前，获取可写的内存区域
-    std::span<char> writable_span(size_t reserve_size = 1024)
+  private:
+    // 每 TrimCheckInterval 次操作检查一次是否到了回收时间，避免每次都读时钟
+    static constexpr uint32_t TrimCheckInterval = 64;
+
+    struct alignas(64) Cache
     {
-        ensure_writable(reserve_size);
-        return {buffer_.data() + write_idx_, buffer_.size() - write_idx_};
+        BufferSegment* head = nullptr;
+        size_t count = 0;
+        // 本回收周期内缓存段数的最低点，这些段整个周期都没有被用到
+        size_t low_water = 0;
+        uint32_t ops = 0;
+        Clock::time_point last_trim = Clock::now();
+        // 所属 P 上已有定时回收协程
+        bool trimming = false;
+        // 只由所属线程写入，stats() 可以在任意线程读取
+        std::atomic<size_t> cached{0};
+        std::atomic<uint64_t> acquired{0};
+        std::atomic<uint64_t> released{0};
+        std::atomic<uint64_t> allocated{0};
+        std::atomic<uint64_t> freed{0};
+
+        BufferSegment* acquire()
+        {
+            bump(acquired);
+            maybe_trim();
+            if (auto segment = head)
+            {
+                head = segment->next;
+                set_count(count - 1);
+                low_water = std::min(low_water, count);
+                return segment;
+            }
+            bump(allocated);
+            return new BufferSegment;
+        }
+
+        void release(BufferSegment* segment)
+        {
+            bump(released);
+            maybe_trim();
+            if (count >= max_cached_.load(std::memory_order_relaxed))
+            {
+                bump(freed);
+                delete segment;
+                return;
+            }
+            segment->next = head;
+            head = segment;
+            set_count(count + 1);
+        }
+
+        void maybe_trim()
+        {
+            if (++ops % TrimCheckInterval != 0)
+            {
+                return;
+            }
+            trim(Clock::now());
+        }
+
+        void trim(Clock::time_point now)
+        {
+            if (now - last_trim < std::chrono::milliseconds(idle_release_.load(std::memory_order_relaxed)))
+            {
+                return;
+            }
+            for (size_t i = 0; i < low_water; ++i)
+            {
+                bump(freed);
+                delete std::exchange(head, head->next);
+            }
+            set_count(count - low_water);
+            low_water = count;
+            last_trim = now;
+        }
+
+        void set_count(size_t value)
+        {
+            count = value;
+            cached.store(value, std::memory_order_relaxed);
+        }
+        static void bump(std::atomic<uint64_t>& counter)
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        }
+
+        auto stats() const -> SegmentPoolStats
+        {
+            return {cached.load(std::memory_order_relaxed), acquired.load(std::memory_order_relaxed),
+                    released.load(std::memory_order_relaxed), allocated.load(std::memory_order_relaxed),
+                    freed.load(std::memory_order_relaxed)};
+        }
+    };
+
+    // 与调度器一样不析构：进程退出时其他 P 的线程可能仍在使用
+    static Cache* caches()
+    {
+        static auto caches = new Cache[utils::processor_count() + 1];
+        return caches;
     }
 
-    // Socket 读完数据后，推进 write_idx
-    void commit_write(size_t bytes) { write_idx_ += bytes; }
+    // 每个回收周期检查一次，缓存清空后退出，下次有段放回缓存时再启动
+    static auto trim_loop(int id) -> utils::Coroutine<>
+    {
+        auto& cache = caches()[id];
+        while (true)
+        {
+            co_await utils::delay(std::chrono::milliseconds(idle_release_.load(std::memory_order_relaxed)));
+            // home 过载时固定协程可能在其他 P 上恢复，此时不能访问这份缓存；让出直到回到 home，不跳过本周期
+            while (utils::current_processor() != id)
+            {
+                co_yield {};
+            }
+            cache.trim(Clock::now());
+            if (cache.count == 0)
+            {
+                cache.trimming = false;
+                co_return;
+            }
+        }
+    }
 
-    bool empty() const { return read_idx_ == write_idx_; }
+    // 调度器以外的线程共用最后一份缓存，需要加锁
+    static auto local() -> std::pair<Cache&, std::unique_lock<std::mutex>>
+    {
+        static std::mutex shared_mutex;
+        if (auto id = utils::current_processor(); id >= 0)
+        {
+            return {caches()[id], std::unique_lock<std::mutex>{}};
+        }
+        return {caches()[utils::processor_count()], std::unique_lock{shared_mutex}};
+    }
 
-  private:
-    std::vector<char> buffer_;
-    size_t read_idx_;
-    size_t write_idx_;
+    inline static std::atomic<size_t> max_cached_{256};
+    inline static std::atomic<int64_t> idle_release_{1000};
+};
 
-    size_t readable_bytes() const { return write_idx_ - read_idx_; }
-    size_t writable_bytes() const { return buffer_.size() - write_idx_; }
-    size_t prependable_bytes() const { return read_idx_; }
+// 由固定大小段串成的缓冲区：扩容只追加新段，已有数据从不移动，也不做清零
+// 可读数据可能跨越多个段，解析器通过 copy_to / append_to 读取，发送时导出 iovec 交给 writev
+class Buffer
+{
+  public:
+    Buffer() = default;
+    ~Buffer() { clear(); }
+    Buffer(const Buffer&) = delete;
+    Buffer& operator=(const Buffer&) = delete;
+    Buffer(Buffer&& other) noexcept
+        : segments_(std::move(other.segments_)), read_idx_(std::exchange(other.read_idx_, 0)),
+          write_idx_(std::exchange(other.write_idx_, 0)), spare_(std::exchange(other.spare_, 0))
+    {
+        other.segments_.clear();
+    }
+    Buffer& operator=(Buffer&& other) noexcept
+    {
+        if (this != &other)
+        {
+            clear();
+            segments_ = std::move(other.segments_);
+            read_idx_ = std::exchange(other.read_idx_, 0);
+            write_idx_ = std::exchange(other.write_idx_, 0);
+            spare_ = std::exchange(other.spare_, 0);
+            other.segments_.clear();
+        }
+        return *this;
+    }
 
-    // 核心逻辑：空间不够时的扩容或内存整理
-    void ensure_writable(size_t len)
+    size_t readable_bytes() const
     {
-        if (writable_bytes() >= len)
+        if (used() == 0)
         {
-            return; // 空间够，什么都不用做
+            return 0;
         }
+        return (used() - 1) * BufferSegment::Size + write_idx_ - read_idx_;
+    }
+    bool empty() const { return readable_bytes() == 0; }
 
-        // 空间不够，但如果 "废弃区 + 空闲区" 的总和够用，就做一次内存碎片整理 (Compact)
-        if (prependable_bytes() + writable_bytes() >= len)
+    // --- 读取 ---
+    // 第一段中的连续可读数据
+    std::span<const char> front() const
+    {
+        if (used() == 0)
         {
-            size_t readable = readable_bytes();
-            // 把现存的有用的数据平移到最前面（这是唯一一次真正发生内存移动的地方，但频率极低）
-            std::copy(buffer_.begin() + read_idx_, buffer_.begin() + write_idx_, buffer_.begin());
-            read_idx_ = 0;
-            write_idx_ = readable;
+            return {};
         }
-        else
+        size_t end = used() == 1 ? write_idx_ : BufferSegment::Size;
+        return {segments_.front()->data + read_idx_, end - read_idx_};
+    }
+    std::span<char> front()
+    {
+        auto span = std::as_const(*this).front();
+        return {const_cast<char*>(span.data()), span.size()};
+    }
+
+    // 从可读数据的 offset 处拷贝最多 len 字节，不消费数据，返回实际拷贝的字节数
+    size_t copy_to(size_t offset, void* dest, size_t len) const
+    {
+        size_t copied = 0;
+        for_each_chunk(offset, len, [&](const char* data, size_t n) {
+            std::memcpy(static_cast<char*>(dest) + copied, data, n);
+            copied += n;
+        });
+        return copied;
+    }
+
+    // 把 [offset, offset + len) 追加到 out 末尾
+    void append_to(size_t offset, size_t len, std::string& out) const
+    {
+        out.reserve(out.size() + len);
+        for_each_chunk(offset, len, [&](const char* data, size_t n) { out.append(data, n); });
+    }
+
+    // 导出可读数据的 iovec 供 writev 使用，返回填充的个数
+    size_t readable_iovecs(std::span<iovec> out) const
+    {
+        size_t count = 0;
+        for (size_t i = 0; i < used() && count < out.size(); ++i)
+        {
+            size_t begin = i == 0 ? read_idx_ : 0;
+            size_t end = i + 1 == used() ? write_idx_ : BufferSegment::Size;
+            if (end > begin)
+            {
+                out[count++] = {segments_[i]->data + begin, end - begin};
+            }
+        }
+        return count;
+    }
+
+    // 消费 bytes 字节，读完的段立即归还
+    void retrieve(size_t bytes)
+    {
+        if (bytes >= readable_bytes())
+        {
+            clear();
+            return;
+        }
+        read_idx_ += bytes;
+        while (read_idx_ >= BufferSegment::Size)
+        {
+            SegmentPool::release(segments_.front());
+            segments_.pop_front();
+            read_idx_ -= BufferSegment::Size;
+        }
+    }
+
+    // 丢弃全部数据，归还包括预挂段在内的所有段
+    void clear()
+    {
+        for (auto segment : segments_)
+        {
+            SegmentPool::release(segment);
+        }
+        segments_.clear();
+        read_idx_ = 0;
+        write_idx_ = 0;
+        spare_ = 0;
+    }
+
+    // --- 写入 ---
+    // 最后一段中的连续可写空间，可能小于 reserve_size；需要一次读满更多数据时用 writable_iovecs
+    std::span<char> writable_span(size_t reserve_size = 1024)
+    {
+        if (segments_.empty() || write_idx_ == BufferSegment::Size)
+        {
+            push_segment();
+        }
+        size_t len = std::min(reserve_size, BufferSegment::Size - write_idx_);
+        return {segments_.back()->data + write_idx_, std::max<size_t>(len, 1)};
+    }
+
+    // 准备至少 reserve_size 字节的可写空间（受 out 容量限制），导出为 iovec 供 readv 使用
+    size_t writable_iovecs(std::span<iovec> out, size_t reserve_size)
+    {
+        if (out.empty())
+        {
+            return 0;
+        }
+        if (segments_.empty() || write_idx_ == BufferSegment::Size)
+        {
+            push_segment();
+        }
+        size_t count = 0;
+        size_t first = BufferSegment::Size - write_idx_;
+        out[count++] = {segments_.back()->data + write_idx_, first};
+        size_t prepared = first;
+        // 预先挂上后续的空段，commit_write 时按实际写入量推进
+        size_t index = used() - 1;
+        while (prepared < reserve_size && count < out.size())
+        {
+            if (++index == segments_.size())
+            {
+                segments_.push_back(SegmentPool::acquire());
+                ++spare_;
+            }
+            out[count++] = {segments_[index]->data, BufferSegment::Size};
+            prepared += BufferSegment::Size;
+        }
+        return count;
+    }
+
+    // 读入 bytes 字节后推进写位置，可跨越 writable_iovecs 准备的多个段
+    void commit_write(size_t bytes)
+    {
+        // 预挂的空段此时才算作已用
+        size_t used_segments = used();
+        write_idx_ += bytes;
+        while (write_idx_ > BufferSegment::Size)
+        {
+            write_idx_ -= BufferSegment::Size;
+            ++used_segments;
+        }
+        // 没有用上的预挂段归还
+        while (segments_.size() > used_segments)
+        {
+            SegmentPool::release(segments_.back());
+            segments_.pop_back();
+        }
+        spare_ = 0;
+    }
+
+    void append(std::span<const char> data)
+    {
+        while (!data.empty())
+        {
+            auto span = writable_span(data.size());
+            size_t n = std::min(span.size(), data.size());
+            std::memcpy(span.data(), data.data(), n);
+            commit_write(n);
+            data = data.subspan(n);
+        }
+    }
+
+  private:
+    std::deque<BufferSegment*> segments_;
+    // 第一段中的读位置和最后一个已用段中的写位置
+    size_t read_idx_{0};
+    size_t write_idx_{0};
+    // writable_iovecs 预挂在末尾、尚未写入的段数
+    size_t spare_{0};
+
+    size_t used() const { return segments_.size() - spare_; }
+
+    void push_segment()
+    {
+        segments_.push_back(SegmentPool::acquire());
+        write_idx_ = 0;
+    }
+
+    template <typename F> void for_each_chunk(size_t offset, size_t len, F&& f) const
+    {
+        offset += read_idx_;
+        size_t i = offset / BufferSegment::Size;
+        offset %= BufferSegment::Size;
+        for (; i < used() && len > 0; ++i, offset = 0)
         {
-            // 真不够了，只能重新分配内存扩容
-            buffer_.resize(write_idx_ + len);
+            size_t end = i + 1 == used() ? write_idx_ : BufferSegment::Size;
+            if (end <= offset)
+            {
+                break;
+            }
+            size_t n = std::min(len, end - offset);
+            f(segments_[i]->data + offset, n);
+            len -= n;
         }
     }
-};
\ No newline at end of file
+};
@@ -1,38 +1,141 @@
 #pragma once
+#include <algorithm>
 #include <arpa/inet.h>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
 #include <string>
 #include <string_view>
+#include <sys/socket.h>
+#include <sys/un.h>
 
 namespace utils
 {
+// 套接字地址：IPv4、IPv6 或 Unix 域（路径或以 '@' 开头的抽象命名空间）
 class InetAddress
 {
   private:
-    struct sockaddr_in addr_{};
+    sockaddr_storage addr_{};
+    socklen_t len_{sizeof(sockaddr_in)};
 
   public:
-    // 1. 供主动发起连接或绑定监听时使用 (例如: 8080, "127.0.0.1")
+    // 1. 供主动发起连接或绑定监听时使用 (例如: 8080, "127.0.0.1" 或 8080, "::1")
     explicit InetAddress(uint16_t port = 0, std::string_view ip = "0.0.0.0")
     {
-        addr_.sin_family = AF_INET;
-        addr_.sin_port = htons(port);
-        inet_pton(AF_INET, ip.data(), &addr_.sin_addr);
+        // inet_pton 需要以 '\0' 结尾的字符串
+        std::string host(ip);
+        if (host.find(':') != std::string::npos)
+        {
+            auto& addr6 = as<sockaddr_in6>();
+            addr6.sin6_family = AF_INET6;
+            addr6.sin6_port = htons(port);
+            inet_pton(AF_INET6, host.c_str(), &addr6.sin6_addr);
+            len_ = sizeof(sockaddr_in6);
+        }
+        else
+        {
+            auto& addr4 = as<sockaddr_in>();
+            addr4.sin_family = AF_INET;
+            addr4.sin_port = htons(port);
+            inet_pton(AF_INET, host.c_str(), &addr4.sin_addr);
+            len_ = sizeof(sockaddr_in);
+        }
     }
 
     // 2. 供 accept 接收到底层结构时转换使用
-    explicit InetAddress(const struct sockaddr_in& addr) : addr_(addr) {}
+    explicit InetAddress(const struct sockaddr_in& addr)
+        : InetAddress(reinterpret_cast<const sockaddr*>(&addr), sizeof(addr))
+    {
+    }
+    explicit InetAddress(const struct sockaddr_in6& addr)
+        : InetAddress(reinterpret_cast<const sockaddr*>(&addr), sizeof(addr))
+    {
+    }
+    InetAddress(const sockaddr* addr, socklen_t len) : len_(len)
+    {
+        std::memcpy(&addr_, addr, std::min<size_t>(len, sizeof(addr_)));
+    }
+
+    // 3. Unix 域地址，"@name" 表示 Linux 抽象命名空间，不在文件系统上创建文件
+    static InetAddress unix_path(std::string_view path)
+    {
+        InetAddress address;
+        address.addr_ = {};
+        auto& un = address.as<sockaddr_un>();
+        if (path.empty() || path.size() >= sizeof(un.sun_path))
+        {
+            throw std::invalid_argument("Invalid unix socket path");
+        }
+        un.sun_family = AF_UNIX;
+        std::memcpy(un.sun_path, path.data(), path.size());
+        if (path.front() == '@')
+        {
+            un.sun_path[0] = '\0';
+        }
+        address.len_ = static_cast<socklen_t>(offsetof(sockaddr_un, sun_path) + path.size() +
+                                              (path.front() == '@' ? 0 : 1));
+        return address;
+    }
 
     // 提供给底层 Socket 调用的内部接口
     const sockaddr* get_sockaddr() const { return reinterpret_cast<const sockaddr*>(&addr_); }
-    socklen_t get_socklen() const { return sizeof(addr_); }
+    socklen_t get_socklen() const { return len_; }
+    int family() const { return addr_.ss_family; }
+    bool is_unix() const { return family() == AF_UNIX; }
 
     // 提供给上层业务调用的可读接口
     std::string ip() const
     {
-        char buf[64] = "";
-        inet_ntop(AF_INET, &addr_.sin_addr, buf, sizeof(buf));
+        char buf[INET6_ADDRSTRLEN] = "";
+        if (family() == AF_INET6)
+        {
+            inet_ntop(AF_INET6, &as<sockaddr_in6>().sin6_addr, buf, sizeof(buf));
+        }
+        else if (family() == AF_INET)
+        {
+            inet_ntop(AF_INET, &as<sockaddr_in>().sin_addr, buf, sizeof(buf));
+        }
         return std::string(buf);
     }
-    uint16_t port() const { return ntohs(addr_.sin_port); }
+    uint16_t port() const
+    {
+        if (family() == AF_INET6)
+        {
+            return ntohs(as<sockaddr_in6>().sin6_port);
+        }
+        return family() == AF_INET ? ntohs(as<sockaddr_in>().sin_port) : 0;
+    }
+    // Unix 域地址的路径，抽象地址以 '@' 开头；未绑定的客户端地址为空
+    std::string path() const
+    {
+        if (!is_unix() || len_ <= offsetof(sockaddr_un, sun_path))
+        {
+            return {};
+        }
+        auto& un = as<sockaddr_un>();
+        size_t n = len_ - offsetof(sockaddr_un, sun_path);
+        if (un.sun_path[0] == '\0')
+        {
+            return "@" + std::string(un.sun_path + 1, n - 1);
+        }
+        return std::string(un.sun_path, strnlen(un.sun_path, n));
+    }
+    // 例如 "127.0.0.1:80"、"[::1]:80"、"/run/app.sock"
+    std::string to_string() const
+    {
+        if (is_unix())
+        {
+            return path();
+        }
+        if (family() == AF_INET6)
+        {
+            return "[" + ip() + "]:" + std::to_string(port());
+        }
+        return ip() + ":" + std::to_string(port());
+    }
+
+  private:
+    template <typename T> T& as() { return *reinterpret_cast<T*>(&addr_); }
+    template <typename T> const T& as() const { return *reinterpret_cast<const T*>(&addr_); }
 };
 } // namespace utils
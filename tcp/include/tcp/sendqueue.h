@@ -0,0 +1,203 @@
+#pragma once
+#include "coroutine/channel.h"
+#include "coroutine/coroutine.h"
+#include "coroutine/cospawn.h"
+#include "coroutine/intrusivelist.h"
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace utils
+{
+// 发送队列的字节水位：排队字节数达到 high 时挂起生产者，写协程把它降到 low 以下后再放行
+struct SendQueueLimits
+{
+    size_t high_watermark = 1024 * 1024;
+    size_t low_watermark = 256 * 1024;
+};
+
+// 按字节限流的多生产者、单消费者发送队列
+// 存储随排队的消息数增长、随发送收缩，空闲连接只占一个空 deque
+class SendQueue
+{
+  public:
+    class PushAwaiter : public IntrusiveListDNode
+    {
+      public:
+        PushAwaiter(SendQueue* queue, std::string&& data) : queue_(queue), data_(std::move(data)) {}
+        bool await_ready() const noexcept { return false; }
+        template <typename Promise> bool await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            promise_ = &handle.promise();
+            return queue_->push_impl(this);
+        }
+        auto await_resume() const { return state_; }
+
+      private:
+        SendQueue* queue_;
+        std::string data_;
+        State state_{State::CLOSED};
+        Promise* promise_{};
+        friend class SendQueue;
+    };
+
+    class PopAwaiter
+    {
+      public:
+        PopAwaiter(SendQueue* queue, std::vector<std::string>& out, size_t max_messages, size_t max_bytes)
+            : queue_(queue), out_(out), max_messages_(max_messages), max_bytes_(max_bytes)
+        {
+        }
+        bool await_ready() const noexcept { return false; }
+        template <typename Promise> bool await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            return queue_->wait_impl(&handle.promise());
+        }
+        // 返回 CLOSED 表示队列已关闭且没有剩余数据
+        auto await_resume() { return queue_->pop_impl(out_, max_messages_, max_bytes_); }
+
+      private:
+        SendQueue* queue_;
+        std::vector<std::string>& out_;
+        size_t max_messages_;
+        size_t max_bytes_;
+    };
+
+    explicit SendQueue(SendQueueLimits limits = {}) : limits_(limits) {}
+    ~SendQueue() { close(); }
+
+    // 排队字节数未达到高水位时立即返回，否则挂起到写协程把队列降到低水位以下
+    auto push(std::string data) { return PushAwaiter{this, std::move(data)}; }
+    // 等到队列非空，取出最多 max_messages 条、累计不超过 max_bytes 的消息（至少一条）追加到 out
+    auto pop(std::vector<std::string>& out, size_t max_messages, size_t max_bytes)
+    {
+        return PopAwaiter{this, out, max_messages, max_bytes};
+    }
+    void close()
+    {
+        IntrusiveDList producers;
+        Promise* consumer = nullptr;
+        {
+            std::lock_guard lock(mutex_);
+            if (closed_)
+            {
+                return;
+            }
+            closed_ = true;
+            while (!producers_.empty())
+            {
+                producers.push_back(producers_.pop_front());
+            }
+            consumer = std::exchange(consumer_, nullptr);
+        }
+        while (!producers.empty())
+        {
+            auto awaiter = static_cast<PushAwaiter*>(producers.pop_front());
+            awaiter->state_ = State::CLOSED;
+            co_spawn(awaiter->promise_);
+        }
+        if (consumer)
+        {
+            co_spawn(consumer);
+        }
+    }
+    size_t queued_bytes() const
+    {
+        std::lock_guard lock(mutex_);
+        return bytes_;
+    }
+
+  private:
+    bool push_impl(PushAwaiter* awaiter)
+    {
+        Promise* consumer = nullptr;
+        {
+            std::lock_guard lock(mutex_);
+            if (closed_)
+            {
+                return false;
+            }
+            // 已有生产者在等待时也排队，保持消息顺序
+            if (bytes_ >= limits_.high_watermark || !producers_.empty())
+            {
+                producers_.push_back(awaiter);
+                return true;
+            }
+            bytes_ += awaiter->data_.size();
+            messages_.push_back(std::move(awaiter->data_));
+            consumer = std::exchange(consumer_, nullptr);
+        }
+        awaiter->state_ = State::OK;
+        if (consumer)
+        {
+            co_spawn(consumer);
+        }
+        return false;
+    }
+
+    bool wait_impl(Promise* promise)
+    {
+        std::lock_guard lock(mutex_);
+        if (!messages_.empty() || closed_)
+        {
+            return false;
+        }
+        consumer_ = promise;
+        return true;
+    }
+
+    State pop_impl(std::vector<std::string>& out, size_t max_messages, size_t max_bytes)
+    {
+        IntrusiveDList admitted;
+        {
+            std::lock_guard lock(mutex_);
+            if (messages_.empty())
+            {
+                return State::CLOSED;
+            }
+            size_t count = 0;
+            size_t bytes = 0;
+            while (!messages_.empty() && count < max_messages && (count == 0 || bytes < max_bytes))
+            {
+                bytes += messages_.front().size();
+                out.push_back(std::move(messages_.front()));
+                messages_.pop_front();
+                ++count;
+            }
+            bytes_ -= bytes;
+            // 降到低水位以下后按顺序放行等待的生产者，直到再次达到高水位
+            if (bytes_ <= limits_.low_watermark)
+            {
+                while (!producers_.empty() && bytes_ < limits_.high_watermark)
+                {
+                    auto awaiter = static_cast<PushAwaiter*>(producers_.pop_front());
+                    bytes_ += awaiter->data_.size();
+                    messages_.push_back(std::move(awaiter->data_));
+                    admitted.push_back(awaiter);
+                }
+            }
+        }
+        while (!admitted.empty())
+        {
+            auto awaiter = static_cast<PushAwaiter*>(admitted.pop_front());
+            awaiter->state_ = State::OK;
+            co_spawn(awaiter->promise_);
+        }
+        return State::OK;
+    }
+
+    SendQueueLimits limits_;
+    mutable std::mutex mutex_;
+    std::deque<std::string> messages_;
+    size_t bytes_{0};
+    // 因超过高水位挂起的生产者
+    IntrusiveDList producers_;
+    // 等待数据的写协程
+    Promise* consumer_{nullptr};
+    bool closed_{false};
+};
+} // namespace utils
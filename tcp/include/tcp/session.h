@@ -1,47 +1,125 @@
+#pragma once
 #include "buffer.h"
 #include "coroutine/channel.h"
 #include "coroutine/coroutine.h"
+#include "sendqueue.h"
 #include "socket.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
 #include <iostream>
 #include <memory>
 #include <ostream>
+#include <vector>
 namespace utils
 {
+// 发送端写合并统计
+struct WriteBatchStats
+{
+    uint64_t writes = 0;
+    uint64_t messages = 0;
+    uint64_t bytes = 0;
+    // 第 i 个桶统计单次 writev 合并的消息数在 [2^i, 2^(i+1)) 的次数，最后一个桶包含更大的批次
+    std::array<uint64_t, 8> batch_histogram{};
+
+    double messages_per_write() const { return writes == 0 ? 0.0 : static_cast<double>(messages) / writes; }
+};
+
+// 多个会话共享的统计计数，可以在任意线程读取
+class WriteBatchCounter
+{
+  public:
+    void record(size_t messages, size_t bytes)
+    {
+        writes_.fetch_add(1, std::memory_order_relaxed);
+        messages_.fetch_add(messages, std::memory_order_relaxed);
+        bytes_.fetch_add(bytes, std::memory_order_relaxed);
+        auto bucket = std::min<size_t>(std::bit_width(messages) - 1, batch_histogram_.size() - 1);
+        batch_histogram_[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+    auto stats() const -> WriteBatchStats
+    {
+        WriteBatchStats stats;
+        stats.writes = writes_.load(std::memory_order_relaxed);
+        stats.messages = messages_.load(std::memory_order_relaxed);
+        stats.bytes = bytes_.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < batch_histogram_.size(); ++i)
+        {
+            stats.batch_histogram[i] = batch_histogram_[i].load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+
+  private:
+    std::atomic<uint64_t> writes_{0};
+    std::atomic<uint64_t> messages_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::array<std::atomic<uint64_t>, 8> batch_histogram_{};
+};
+
 class RpcSession : public std::enable_shared_from_this<RpcSession>
 {
   private:
-    constexpr static size_t Capacity = 1024;
+    // 单次 writev 最多合并的消息数和字节数，避免一个会话长时间占着写协程
+    constexpr static size_t MaxBatchMessages = 64;
+    constexpr static size_t MaxBatchBytes = 256 * 1024;
     Socket socket_;
-    Channel<std::string, Capacity> send_channel_;
-    // 私有的写协程
+    // 按字节而不是消息数限流，慢速对端积压的响应不会超过高水位
+    SendQueue send_queue_;
+    std::shared_ptr<WriteBatchCounter> counter_;
+    // 私有的写协程：取出当前排队的所有响应，合并成一次 writev
     static Coroutine<> write_loop(std::shared_ptr<RpcSession> session)
     {
+        std::vector<std::string> batch;
+        std::vector<iovec> iovs;
         while (true)
         {
-            auto [data, err] = co_await session->send_channel_.recv();
-            if (err != State::OK)
+            if (co_await session->send_queue_.pop(batch, MaxBatchMessages, MaxBatchBytes) != State::OK)
             {
                 break;
             }
 
-            auto count = co_await session->socket_.send(data);
-            if (count < 0)
+            size_t bytes = 0;
+            iovs.clear();
+            for (auto& message : batch)
+            {
+                iovs.push_back({message.data(), message.size()});
+                bytes += message.size();
+            }
+            // 部分写入由 writev 内部续写，返回值是写出的总字节数
+            auto count = co_await session->socket_.writev(iovs);
+            if (count <= 0)
             {
                 break;
             }
+            if (session->counter_)
+            {
+                session->counter_->record(batch.size(), bytes);
+            }
+            batch.clear();
         }
         session->close();
     }
 
   public:
-    explicit RpcSession(Socket sock) : socket_(std::move(sock)) {}
+    explicit RpcSession(Socket sock, std::shared_ptr<WriteBatchCounter> counter = nullptr,
+                        SendQueueLimits limits = {})
+        : socket_(std::move(sock)), send_queue_(limits), counter_(std::move(counter))
+    {
+    }
     void start() { co_spawn(write_loop(shared_from_this())); }
     auto recv(std::span<char> buffer) { return socket_.recv(buffer); }
-    // TODO 实现一个发送缓存
-    auto send(std::string data) { return send_channel_.send(std::move(data)); }
+    auto readv(std::span<const iovec> iov) { return socket_.readv(iov); }
+    auto try_readv(std::span<const iovec> iov) { return socket_.try_readv(iov); }
+    auto wait_readable() { return socket_.wait_readable(); }
+    // 排队字节数达到高水位时挂起，直到写协程把队列降到低水位以下
+    auto send(std::string data) { return send_queue_.push(std::move(data)); }
+    auto queued_bytes() const { return send_queue_.queued_bytes(); }
     void close()
     {
-        send_channel_.close();
+        send_queue_.close();
         return socket_.close();
     }
 };
@@ -2,10 +2,12 @@
 #include "coroutine/coroutine.h"
 #include "coroutine/syscall.h"
 #include "inetaddress.h"
+#include <cerrno>
 #include <coroutine>
 #include <span>
 #include <stdexcept>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <unistd.h>
 namespace utils
 {
@@ -97,14 +99,36 @@ class Socket
     {
         return ::utils::send(fd_, buffer.data(), buffer.size(), flags);
     }
+    // 分散读/聚集写：头部和包体可以来自不同的缓冲区，无需拼接
+    auto readv(std::span<const iovec> iov) noexcept { return ::utils::readv(fd_, iov.data(), iov.size()); }
+    // 非阻塞读，不经过 ring：返回读到的字节数，暂无数据返回 -EAGAIN，出错返回 -errno
+    int try_recv(std::span<char> buffer) noexcept
+    {
+        auto n = ::recv(fd_, buffer.data(), buffer.size(), MSG_DONTWAIT);
+        return n < 0 ? -errno : static_cast<int>(n);
+    }
+    int try_readv(std::span<const iovec> iov) noexcept
+    {
+        msghdr msg{};
+        msg.msg_iov = const_cast<iovec*>(iov.data());
+        msg.msg_iovlen = iov.size();
+        auto n = ::recvmsg(fd_, &msg, MSG_DONTWAIT);
+        return n < 0 ? -errno : static_cast<int>(n);
+    }
+    // 等待可读，不读取数据；返回就绪的事件掩码，出错返回 -errno
+    auto wait_readable() noexcept { return ::utils::poll(fd_, POLLIN); }
+    // 部分写入时会修改 iov，调用方需保证 iov 在完成前有效
+    auto writev(std::span<iovec> iov) noexcept { return ::utils::writev(fd_, iov.data(), iov.size()); }
+    auto recvmsg(msghdr& msg, int flags = 0) noexcept { return ::utils::recvmsg(fd_, &msg, flags); }
+    auto sendmsg(msghdr& msg, int flags = 0) noexcept { return ::utils::sendmsg(fd_, &msg, flags); }
     // ==========================================================
     // Accept Awaiter：直接组装并返回包含完整地址信息的 Socket
     // ==========================================================
     struct SocketAcceptAwaiter
     {
         int listen_fd_;
-        struct sockaddr_in peer_addr_struct{};
-        socklen_t peer_len{sizeof(sockaddr_in)};
+        struct sockaddr_storage peer_addr_struct{};
+        socklen_t peer_len{sizeof(sockaddr_storage)};
         utils::AcceptAwaiter inner_awaiter;
 
         explicit SocketAcceptAwaiter(int listen_fd)
@@ -139,12 +163,13 @@ class Socket
                 return Socket{-1};
             }
             // 获取本地地址 (可选，因为 accept 出的 socket 也有自己的本地端口，特别是在多网卡时)
-            struct sockaddr_in local_addr_struct{};
+            struct sockaddr_storage local_addr_struct{};
             socklen_t local_len = sizeof(local_addr_struct);
             ::getsockname(client_fd, (sockaddr*)&local_addr_struct, &local_len);
 
             // 构造一个完全体的 Socket 返回
-            return Socket{client_fd, InetAddress(local_addr_struct), InetAddress(peer_addr_struct)};
+            return Socket{client_fd, InetAddress((sockaddr*)&local_addr_struct, local_len),
+                          InetAddress((sockaddr*)&peer_addr_struct, peer_len)};
         }
     };
 
@@ -167,5 +192,19 @@ class Socket
         }
         return Socket{fd};
     }
+    // 按地址族创建流式 socket：IPv4/IPv6 为 TCP，AF_UNIX 为 Unix 域流
+    static Socket create_stream(int family)
+    {
+        if (family != AF_UNIX)
+        {
+            return create_tcp(family);
+        }
+        int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Failed to create unix socket");
+        }
+        return Socket{fd};
+    }
 };
 } // namespace utils
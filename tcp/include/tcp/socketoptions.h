@@ -0,0 +1,105 @@
+#pragma once
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+namespace utils
+{
+// 声明式的 socket 选项，0/false 表示保持系统默认
+// 监听 socket 用 apply_listener，accept 出来的和主动连接的 socket 用 apply_connection / apply_client
+// 只对 TCP 有意义的选项在 Unix 域 socket 上自动跳过
+struct SocketOptions
+{
+    // 关闭 Nagle，小包立即发出
+    bool tcp_nodelay = false;
+    // 连接建立时立即回 ACK；内核可能自行退回延迟 ACK 模式，只是提示
+    bool tcp_quickack = false;
+    // SO_BUSY_POLL：阻塞读时在网卡队列上忙等的微秒数，超过 net.core.busy_read 需要 CAP_NET_ADMIN
+    int busy_poll_us = 0;
+    // TCP_DEFER_ACCEPT：数据到达（或超过该秒数）才唤醒 accept，仅监听 socket
+    int defer_accept_s = 0;
+    // TCP_FASTOPEN：服务端 TFO 队列长度，仅监听 socket
+    int fastopen_queue = 0;
+    // TCP_FASTOPEN_CONNECT：客户端在 SYN 中携带首包数据
+    bool fastopen_connect = false;
+    int send_buffer = 0;
+    int recv_buffer = 0;
+    // TCP_NOTSENT_LOWAT：未发送数据超过该值时不再报告可写，减少发送队列里的排队延迟
+    int notsent_lowat = 0;
+
+    // 面向 RPC 的低延迟配置
+    static SocketOptions low_latency()
+    {
+        SocketOptions options;
+        options.tcp_nodelay = true;
+        options.tcp_quickack = true;
+        options.defer_accept_s = 1;
+        options.notsent_lowat = 16 * 1024;
+        return options;
+    }
+
+    // 返回 false 表示有选项设置失败（例如内核不支持或权限不足），已设置的选项仍然生效
+    bool apply_listener(int fd) const
+    {
+        bool tcp = is_tcp(fd);
+        bool ok = apply_common(fd, tcp);
+        if (tcp)
+        {
+            ok &= set(fd, IPPROTO_TCP, TCP_DEFER_ACCEPT, defer_accept_s);
+            ok &= set(fd, IPPROTO_TCP, TCP_FASTOPEN, fastopen_queue);
+        }
+        return ok;
+    }
+
+    bool apply_connection(int fd) const { return apply_connection(fd, is_tcp(fd)); }
+
+    // 在 connect 之前调用
+    bool apply_client(int fd) const
+    {
+        bool tcp = is_tcp(fd);
+        bool ok = apply_connection(fd, tcp);
+        if (tcp)
+        {
+            ok &= set(fd, IPPROTO_TCP, TCP_FASTOPEN_CONNECT, fastopen_connect);
+        }
+        return ok;
+    }
+
+  private:
+    bool apply_connection(int fd, bool tcp) const
+    {
+        bool ok = apply_common(fd, tcp);
+        if (tcp)
+        {
+            ok &= set(fd, IPPROTO_TCP, TCP_NODELAY, tcp_nodelay);
+            ok &= set(fd, IPPROTO_TCP, TCP_QUICKACK, tcp_quickack);
+            ok &= set(fd, IPPROTO_TCP, TCP_NOTSENT_LOWAT, notsent_lowat);
+        }
+        return ok;
+    }
+
+    bool apply_common(int fd, bool tcp) const
+    {
+        bool ok = set(fd, SOL_SOCKET, SO_SNDBUF, send_buffer);
+        ok &= set(fd, SOL_SOCKET, SO_RCVBUF, recv_buffer);
+        if (tcp)
+        {
+            ok &= set(fd, SOL_SOCKET, SO_BUSY_POLL, busy_poll_us);
+        }
+        return ok;
+    }
+
+    static bool is_tcp(int fd)
+    {
+        int protocol = 0;
+        socklen_t len = sizeof(protocol);
+        return ::getsockopt(fd, SOL_SOCKET, SO_PROTOCOL, &protocol, &len) == 0 && protocol == IPPROTO_TCP;
+    }
+
+    // 保持默认值的选项不做系统调用
+    static bool set(int fd, int level, int name, int value)
+    {
+        return value == 0 || ::setsockopt(fd, level, name, &value, sizeof(value)) == 0;
+    }
+};
+} // namespace utils
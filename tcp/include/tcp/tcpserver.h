@@ -1,10 +1,41 @@
 #pragma once
 #include "coroutine/coroutine.h"
+#include "coroutine/mutex.h"
+#include "coroutine/waitgroup.h"
 #include "socket.h"
+#include "socketoptions.h"
+#include <atomic>
 #include <functional>
+#include <stdexcept>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
 namespace utils
 {
 class Socket;
+
+// 过载保护：连接数达到上限后暂停 accept，新连接留在内核 backlog 中
+struct ConnectionLimits
+{
+    // 最大并发连接数，0 表示不限制
+    size_t max_connections = 0;
+    // 暂停后活跃连接降到该值才恢复 accept，必须小于 max_connections，0 或不小于上限时取 max_connections 的 90%
+    size_t resume_connections = 0;
+    // 满载时不暂停，而是 accept 后立即以 RST 关闭，让客户端尽快转向其他实例
+    bool reject_when_full = false;
+};
+
+struct ConnectionStats
+{
+    uint64_t accepted = 0;
+    // 满载时被立即关闭的连接
+    uint64_t rejected = 0;
+    // accept 因满载暂停的次数
+    uint64_t paused = 0;
+    size_t active = 0;
+};
+
 class TcpServer
 {
   public:
@@ -15,20 +46,74 @@ class TcpServer
     Socket listen_socket_;
     InetAddress server_addr_;
     ConnectionHandler on_connection_;
+    // 新连接的 home P 选择策略，默认不固定
+    PinPolicy pin_policy_{PinPolicy::NONE};
+    // 分片模式：每个 P 一个 SO_REUSEPORT 监听 socket 和 accept 循环
+    bool sharded_{false};
+    bool incoming_cpu_hint_{false};
+    std::vector<Socket> shard_sockets_;
+    // 应用到监听 socket 和每个 accept 出来的连接
+    SocketOptions socket_options_;
+    ConnectionLimits limits_;
+    std::atomic<size_t> active_{0};
+    std::atomic<uint64_t> accepted_{0};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<uint64_t> paused_{0};
+    // 暂停的 accept 循环在此等待，活跃连接降到恢复水位时由 track_connection 唤醒
+    Mutex resume_mutex_;
+    ConditionVariable resume_cv_{resume_mutex_};
+    // 监听在 Unix 路径上时记录路径，析构时删除 socket 文件
+    std::string bound_path_;
 
   public:
     // 构造函数：初始化监听 Socket
+    // 地址可以是 IPv4、IPv6 或 Unix 域路径（InetAddress::unix_path）
     TcpServer(const InetAddress& addr) : server_addr_(addr)
     {
-        listen_socket_ = Socket::create_tcp();
+        listen_socket_ = Socket::create_stream(addr.family());
 
         // 设置 SO_REUSEADDR，防止服务端重启时报 "Address already in use"
-        int opt = 1;
-        ::setsockopt(listen_socket_.fd(), SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+        if (!addr.is_unix())
+        {
+            int opt = 1;
+            ::setsockopt(listen_socket_.fd(), SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+        }
+    }
+    ~TcpServer()
+    {
+        if (!bound_path_.empty())
+        {
+            ::unlink(bound_path_.c_str());
+        }
     }
 
     // 注册业务处理函数
     void set_connection_handler(ConnectionHandler handler) { on_connection_ = std::move(handler); }
+    // 固定后连接协程始终在 home P 上恢复，IO 完成都落在同一个 ring 上
+    void set_pin_policy(PinPolicy policy) { pin_policy_ = policy; }
+    // 分片模式下由内核在各监听 socket 间分发连接，每个分片的连接直接落在对应 P 上；
+    // 开启固定策略时连接固定在接受它的 P（不再按策略另选）
+    void set_sharded(bool sharded) { sharded_ = sharded; }
+    // 分片 i 设置 SO_INCOMING_CPU = i，提示内核把该 CPU 上收到的连接交给对应分片，需配合线程绑核才有意义
+    void set_incoming_cpu_hint(bool enable) { incoming_cpu_hint_ = enable; }
+    // 在 start 之前调用
+    void set_socket_options(const SocketOptions& options) { socket_options_ = options; }
+    // 在 start 之前调用
+    void set_connection_limits(const ConnectionLimits& limits)
+    {
+        limits_ = limits;
+        if (limits_.resume_connections == 0 || limits_.resume_connections >= limits_.max_connections)
+        {
+            limits_.resume_connections = limits_.max_connections * 9 / 10;
+        }
+    }
+    auto connection_stats() const -> ConnectionStats
+    {
+        return {.accepted = accepted_.load(std::memory_order_relaxed),
+                .rejected = rejected_.load(std::memory_order_relaxed),
+                .paused = paused_.load(std::memory_order_relaxed),
+                .active = active_.load(std::memory_order_relaxed)};
+    }
 
     // 启动服务器的主循环 (注意：这本身也是一个协程)
     auto start() -> Coroutine<>
@@ -37,26 +122,198 @@ class TcpServer
         {
             throw std::runtime_error("Connection handler not set before starting server");
         }
+        if (sharded_)
+        {
+            open_shards();
+            return run_shards();
+        }
 
-        listen_socket_.bind(server_addr_);
+        if (auto path = server_addr_.path(); !path.empty() && path.front() != '@')
+        {
+            // 上次异常退出遗留的 socket 文件会导致 bind 失败，只删除 socket 文件，路径配错时不误删普通文件
+            struct stat st{};
+            if (::lstat(path.c_str(), &st) == 0)
+            {
+                if (!S_ISSOCK(st.st_mode))
+                {
+                    throw std::runtime_error("Socket bind failed: " + path + " exists and is not a socket");
+                }
+                ::unlink(path.c_str());
+            }
+            listen_socket_.bind(server_addr_);
+            bound_path_ = std::move(path);
+        }
+        else
+        {
+            listen_socket_.bind(server_addr_);
+        }
+        // TCP_FASTOPEN 必须在 listen 之前设置
+        socket_options_.apply_listener(listen_socket_.fd());
         listen_socket_.listen();
 
-        printf("TcpServer started, listening on %s:%d\n", server_addr_.ip().c_str(), server_addr_.port());
+        printf("TcpServer started, listening on %s\n", server_addr_.to_string().c_str());
+        return accept_loop(listen_socket_, -1);
+    }
+
+  private:
+    void open_shards()
+    {
+        if (server_addr_.is_unix())
+        {
+            throw std::runtime_error("Sharded mode requires a TCP address");
+        }
+        // 分片 socket 代替构造时创建的监听 socket
+        listen_socket_.close();
+        auto shards = processor_count();
+        shard_sockets_.reserve(shards);
+        for (size_t i = 0; i < shards; ++i)
+        {
+            auto& listener = shard_sockets_.emplace_back(Socket::create_tcp(server_addr_.family()));
+            int opt = 1;
+            ::setsockopt(listener.fd(), SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+            if (::setsockopt(listener.fd(), SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0)
+            {
+                throw std::runtime_error("Failed to set SO_REUSEPORT");
+            }
+            if (incoming_cpu_hint_)
+            {
+                int cpu = static_cast<int>(i);
+                ::setsockopt(listener.fd(), SOL_SOCKET, SO_INCOMING_CPU, &cpu, sizeof(cpu));
+            }
+            listener.bind(server_addr_);
+            if (i == 0 && server_addr_.port() == 0)
+            {
+                // 端口由内核分配时，其余分片必须绑定到同一个端口
+                sockaddr_storage bound{};
+                socklen_t len = sizeof(bound);
+                ::getsockname(listener.fd(), reinterpret_cast<sockaddr*>(&bound), &len);
+                server_addr_ = InetAddress(reinterpret_cast<sockaddr*>(&bound), len);
+            }
+            socket_options_.apply_listener(listener.fd());
+            listener.listen();
+        }
+
+        printf("TcpServer started, listening on %s with %zu shards\n", server_addr_.to_string().c_str(), shards);
+    }
+
+    auto run_shards() -> Coroutine<>
+    {
+        auto shards = shard_sockets_.size();
+        // 每个分片的 accept 循环固定在对应 P 上
+        WaitGroup wg;
+        wg.add(static_cast<int>(shards));
+        for (size_t i = 0; i < shards; ++i)
+        {
+            co_spawn_pinned(sharded_accept_loop(shard_sockets_[i], static_cast<int>(i), wg), static_cast<int>(i));
+        }
+        co_await wg.wait();
+    }
+
+    auto sharded_accept_loop(Socket& listener, int shard, WaitGroup& wg) -> Coroutine<>
+    {
+        co_await accept_loop(listener, shard);
+        wg.done();
+    }
 
+    // shard < 0 表示非分片模式，按 pin_policy_ 选择 home
+    auto accept_loop(Socket& listener, int shard) -> Coroutine<>
+    {
         // 核心：无尽的 accept 循环
         while (true)
         {
+            if (!limits_.reject_when_full && full())
+            {
+                // 满载：停止 accept，直到活跃连接降到恢复水位
+                co_await pause_accept();
+            }
+
             // 1. 异步等待新连接，协程在此挂起，不阻塞主线程
-            Socket client_socket = co_await listen_socket_.accept();
+            Socket client_socket = co_await listener.accept();
 
             // 2. 如果接受连接成功
             if (client_socket.is_valid())
             {
-                // 3. 调用用户注册的 handler 生成协程，并用 co_spawn 扔给调度器去执行
+                // 先占住一个名额再派发，分片模式下多个 accept 循环并发时也不会超过上限
+                bool reserved = try_reserve();
+                while (!reserved && !limits_.reject_when_full)
+                {
+                    // 名额被其他分片抢先占满：保留这条连接，恢复后再占位
+                    co_await pause_accept();
+                    reserved = try_reserve();
+                }
+                if (!reserved)
+                {
+                    reject(client_socket);
+                    continue;
+                }
+                accepted_.fetch_add(1, std::memory_order_relaxed);
+                socket_options_.apply_connection(client_socket.fd());
+                // 3. 调用用户注册的 handler 生成协程，按策略固定到 home P 后扔给调度器去执行
                 // 注意：使用 std::move 把 Socket 的所有权安全地转移给业务协程
-                co_spawn(on_connection_(std::move(client_socket)));
+                int home = -1;
+                if (pin_policy_ != PinPolicy::NONE)
+                {
+                    home = shard >= 0 ? shard : pick_processor(pin_policy_);
+                }
+                co_spawn_pinned(track_connection(std::move(client_socket)), home);
             }
         }
     }
+
+    bool full() const
+    {
+        return limits_.max_connections > 0 && active_.load(std::memory_order_relaxed) >= limits_.max_connections;
+    }
+
+    // 活跃连接数未达上限时加一并返回 true
+    bool try_reserve()
+    {
+        if (limits_.max_connections == 0)
+        {
+            active_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+        auto current = active_.load(std::memory_order_relaxed);
+        while (current < limits_.max_connections)
+        {
+            if (active_.compare_exchange_weak(current, current + 1, std::memory_order_relaxed))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    auto pause_accept() -> Coroutine<>
+    {
+        paused_.fetch_add(1, std::memory_order_relaxed);
+        co_await resume_mutex_.lock();
+        co_await resume_cv_.wait(
+            [this] { return active_.load(std::memory_order_relaxed) <= limits_.resume_connections; });
+        resume_mutex_.unlock();
+    }
+
+    void reject(Socket& socket)
+    {
+        // SO_LINGER 超时为 0：close 时直接发 RST，不进入 TIME_WAIT
+        linger opt{.l_onoff = 1, .l_linger = 0};
+        ::setsockopt(socket.fd(), SOL_SOCKET, SO_LINGER, &opt, sizeof(opt));
+        socket.close();
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // handler 返回时活跃连接数减一；handler 协程继承外层的 home
+    auto track_connection(Socket socket) -> Coroutine<>
+    {
+        co_await on_connection_(std::move(socket));
+        // 每次只减一，从上方降到恢复水位时必然恰好经过它，只在这一次唤醒暂停的 accept 循环
+        if (active_.fetch_sub(1, std::memory_order_relaxed) - 1 == limits_.resume_connections &&
+            limits_.max_connections > 0)
+        {
+            co_await resume_mutex_.lock();
+            resume_cv_.notify_all();
+            resume_mutex_.unlock();
+        }
+    }
 };
 } // namespace utils
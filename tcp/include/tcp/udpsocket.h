@@ -0,0 +1,292 @@
+#pragma once
+#include "coroutine/coroutine.h"
+#include "coroutine/syscall.h"
+#include "inetaddress.h"
+#include "socket.h"
+#include <cerrno>
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <span>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <vector>
+namespace utils
+{
+// ==========================================================
+// 一组报文槽位，供 recvmmsg/sendmmsg 批量收发
+// 所有槽位共用一块连续内存，收发过程中不再分配
+// ==========================================================
+class UdpBatch
+{
+  private:
+    size_t slot_size_;
+    size_t size_{0};
+    std::vector<char> buffer_;
+    std::vector<mmsghdr> msgs_;
+    std::vector<iovec> iovs_;
+    std::vector<sockaddr_storage> addrs_;
+    // 每个槽位一段辅助数据，接收 UDP_GRO 的段长或发送 UDP_SEGMENT
+    static constexpr size_t control_size = CMSG_SPACE(sizeof(int));
+    std::vector<char> control_;
+
+  public:
+    // 开启 GRO 时一个槽位可能收到多个合并的报文，slot_size 应按合并后的大小设置（最大 64KB）
+    UdpBatch(size_t capacity, size_t slot_size)
+        : slot_size_(slot_size), buffer_(capacity * slot_size), msgs_(capacity), iovs_(capacity), addrs_(capacity),
+          control_(capacity * control_size)
+    {
+    }
+
+    size_t capacity() const { return msgs_.size(); }
+    size_t size() const { return size_; }
+    bool full() const { return size_ == msgs_.size(); }
+    void clear() { size_ = 0; }
+
+    // --- 接收结果 ---
+    auto data(size_t i) const -> std::span<const char> { return {slot(i), msgs_[i].msg_len}; }
+    auto peer(size_t i) const -> InetAddress
+    {
+        return InetAddress(reinterpret_cast<const sockaddr*>(&addrs_[i]), msgs_[i].msg_hdr.msg_namelen);
+    }
+    // 内核通过 GRO 合并的报文按该长度切分，0 表示槽位里只有一个报文
+    int segment_size(size_t i) const
+    {
+        auto& hdr = msgs_[i].msg_hdr;
+        for (auto cmsg = CMSG_FIRSTHDR(&hdr); cmsg; cmsg = CMSG_NXTHDR(const_cast<msghdr*>(&hdr), cmsg))
+        {
+            if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO)
+            {
+                int size;
+                std::memcpy(&size, CMSG_DATA(cmsg), sizeof(size));
+                return size;
+            }
+        }
+        return 0;
+    }
+
+    // --- 组装待发送的报文 ---
+    // 拷贝 payload 到下一个槽位；已连接的 socket 不需要 to
+    // segment_size 非 0 时由内核按该长度把 payload 切成多个报文发送（UDP GSO）
+    bool push(std::span<const char> payload, const InetAddress* to = nullptr, int segment_size = 0)
+    {
+        if (full() || payload.size() > slot_size_)
+        {
+            return false;
+        }
+        auto i = size_++;
+        std::memcpy(slot(i), payload.data(), payload.size());
+        reset_slot(i, payload.size());
+        auto& hdr = msgs_[i].msg_hdr;
+        if (to)
+        {
+            std::memcpy(&addrs_[i], to->get_sockaddr(), to->get_socklen());
+            hdr.msg_namelen = to->get_socklen();
+        }
+        else
+        {
+            hdr.msg_name = nullptr;
+            hdr.msg_namelen = 0;
+        }
+        if (segment_size > 0)
+        {
+            hdr.msg_controllen = CMSG_SPACE(sizeof(uint16_t));
+            auto cmsg = CMSG_FIRSTHDR(&hdr);
+            cmsg->cmsg_level = SOL_UDP;
+            cmsg->cmsg_type = UDP_SEGMENT;
+            cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+            uint16_t gso = static_cast<uint16_t>(segment_size);
+            std::memcpy(CMSG_DATA(cmsg), &gso, sizeof(gso));
+        }
+        else
+        {
+            hdr.msg_control = nullptr;
+            hdr.msg_controllen = 0;
+        }
+        return true;
+    }
+
+  private:
+    char* slot(size_t i) { return buffer_.data() + i * slot_size_; }
+    const char* slot(size_t i) const { return buffer_.data() + i * slot_size_; }
+
+    void reset_slot(size_t i, size_t len)
+    {
+        iovs_[i] = {slot(i), len};
+        auto& hdr = msgs_[i].msg_hdr;
+        hdr = {};
+        hdr.msg_name = &addrs_[i];
+        hdr.msg_namelen = sizeof(sockaddr_storage);
+        hdr.msg_iov = &iovs_[i];
+        hdr.msg_iovlen = 1;
+        hdr.msg_control = control_.data() + i * control_size;
+        hdr.msg_controllen = control_size;
+        msgs_[i].msg_len = 0;
+    }
+
+    // 接收前把所有槽位恢复成满长度
+    void prepare_recv()
+    {
+        size_ = 0;
+        for (size_t i = 0; i < msgs_.size(); ++i)
+        {
+            reset_slot(i, slot_size_);
+        }
+    }
+
+    friend class UdpSocket;
+};
+
+// ==========================================================
+// UDP socket：单个报文走 io_uring 的 recvmsg/sendmsg
+// 批量收发先用非阻塞的 recvmmsg/sendmmsg 一次系统调用处理多个报文，
+// 没有数据（或发送缓冲区满）时才挂起在 io_uring 上等待第一个报文
+// ==========================================================
+class UdpSocket
+{
+  private:
+    Socket socket_;
+
+  public:
+    UdpSocket() = default;
+    explicit UdpSocket(Socket socket) : socket_(std::move(socket)) {}
+
+    static UdpSocket create(int family = AF_INET)
+    {
+        int fd = ::socket(family, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, IPPROTO_UDP);
+        if (fd < 0)
+        {
+            throw std::runtime_error("Failed to create UDP socket");
+        }
+        return UdpSocket(Socket{fd});
+    }
+
+    int fd() const { return socket_.fd(); }
+    bool is_valid() const { return socket_.is_valid(); }
+    const InetAddress& local_address() const { return socket_.local_address(); }
+    void close() { socket_.close(); }
+
+    void bind(const InetAddress& addr) { socket_.bind(addr); }
+    // UDP 的 connect 只记录默认对端，不产生网络交互，同步完成即可
+    void connect(const InetAddress& addr)
+    {
+        if (::connect(fd(), addr.get_sockaddr(), addr.get_socklen()) < 0)
+        {
+            throw std::runtime_error("UDP connect failed");
+        }
+    }
+
+    // 对所有发送生效的 GSO 段长，0 关闭
+    bool set_gso_segment(int segment_size)
+    {
+        return ::setsockopt(fd(), SOL_UDP, UDP_SEGMENT, &segment_size, sizeof(segment_size)) == 0;
+    }
+    // 开启后内核会把同一流的多个报文合并后交付，段长见 UdpBatch::segment_size
+    bool set_gro(bool enable)
+    {
+        int opt = enable ? 1 : 0;
+        return ::setsockopt(fd(), SOL_UDP, UDP_GRO, &opt, sizeof(opt)) == 0;
+    }
+    // 收发缓冲区，高包量场景下默认值容易丢包
+    bool set_buffer_size(int bytes)
+    {
+        return ::setsockopt(fd(), SOL_SOCKET, SO_RCVBUF, &bytes, sizeof(bytes)) == 0 &&
+               ::setsockopt(fd(), SOL_SOCKET, SO_SNDBUF, &bytes, sizeof(bytes)) == 0;
+    }
+
+    // --- 单个报文 ---
+    auto recvmsg(msghdr& msg, int flags = 0) noexcept { return socket_.recvmsg(msg, flags); }
+    auto sendmsg(msghdr& msg, int flags = 0) noexcept { return socket_.sendmsg(msg, flags); }
+    // 已连接的 socket 直接收发
+    auto recv(std::span<char> buffer) noexcept { return socket_.recv(buffer); }
+    auto send(std::span<const char> buffer) noexcept { return socket_.send(buffer); }
+
+    // 返回报文长度，from 为发送方地址；报文超过 buffer 时被截断
+    auto recv_from(std::span<char> buffer, InetAddress& from) -> Coroutine<int>
+    {
+        sockaddr_storage addr{};
+        iovec iov{buffer.data(), buffer.size()};
+        msghdr msg{};
+        msg.msg_name = &addr;
+        msg.msg_namelen = sizeof(addr);
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        int n = co_await socket_.recvmsg(msg);
+        if (n >= 0)
+        {
+            from = InetAddress(reinterpret_cast<sockaddr*>(&addr), msg.msg_namelen);
+        }
+        co_return n;
+    }
+
+    auto send_to(std::span<const char> buffer, const InetAddress& to) -> Coroutine<int>
+    {
+        iovec iov{const_cast<char*>(buffer.data()), buffer.size()};
+        msghdr msg{};
+        msg.msg_name = const_cast<sockaddr*>(to.get_sockaddr());
+        msg.msg_namelen = to.get_socklen();
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        co_return co_await socket_.sendmsg(msg);
+    }
+
+    // --- 批量 ---
+    // 至少收到一个报文才返回，返回收到的报文数，失败返回 -errno
+    auto recv_batch(UdpBatch& batch) -> Coroutine<int>
+    {
+        batch.prepare_recv();
+        int n = ::recvmmsg(fd(), batch.msgs_.data(), batch.capacity(), MSG_DONTWAIT, nullptr);
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+        {
+            co_return -errno;
+        }
+        if (n <= 0)
+        {
+            // 队列为空：挂起等第一个报文，醒来后顺带取走已经到达的其余报文
+            auto& first = batch.msgs_[0];
+            int len = co_await socket_.recvmsg(first.msg_hdr);
+            if (len < 0)
+            {
+                co_return len;
+            }
+            first.msg_len = len;
+            n = 1;
+            if (batch.capacity() > 1)
+            {
+                int more = ::recvmmsg(fd(), batch.msgs_.data() + 1, batch.capacity() - 1, MSG_DONTWAIT, nullptr);
+                n += more > 0 ? more : 0;
+            }
+        }
+        batch.size_ = n;
+        co_return n;
+    }
+
+    // 发送 batch 中的全部报文，返回发送的报文数；中途出错时返回已发送数，一个都没发出时返回 -errno
+    auto send_batch(UdpBatch& batch) -> Coroutine<int>
+    {
+        size_t sent = 0;
+        while (sent < batch.size())
+        {
+            int n = ::sendmmsg(fd(), batch.msgs_.data() + sent, batch.size() - sent, MSG_DONTWAIT);
+            if (n > 0)
+            {
+                sent += n;
+                continue;
+            }
+            if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+            {
+                co_return sent > 0 ? static_cast<int>(sent) : -errno;
+            }
+            // 发送缓冲区满：挂起发送一个报文，等内核腾出空间
+            int len = co_await socket_.sendmsg(batch.msgs_[sent].msg_hdr);
+            if (len < 0)
+            {
+                co_return sent > 0 ? static_cast<int>(sent) : len;
+            }
+            ++sent;
+        }
+        co_return static_cast<int>(sent);
+    }
+};
+} // namespace utils
@@ -0,0 +1,390 @@
+#include "coroutine/main.h"
+#include "coroutine/syscall.h"
+#include "tcp/buffer.h"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+
+namespace utils
+{
+
+constexpr size_t Seg = BufferSegment::Size;
+
+// 按顺序生成内容，跨段后仍能从字节值看出错位
+struct Pattern
+{
+    char next = 'a';
+    auto take(size_t n) -> std::string
+    {
+        std::string data(n, '\0');
+        for (auto& c : data)
+        {
+            c = next;
+            next = next == 'z' ? 'a' : static_cast<char>(next + 1);
+        }
+        return data;
+    }
+};
+
+// 用各个读取接口取出全部可读数据，与 model 对比
+void check(const Buffer& buffer, const std::string& model)
+{
+    assert(buffer.readable_bytes() == model.size());
+    assert(buffer.empty() == model.empty());
+
+    auto front = buffer.front();
+    assert(front.size() <= model.size());
+    assert(model.compare(0, front.size(), front.data(), front.size()) == 0);
+
+    std::array<iovec, 64> iov{};
+    size_t count = buffer.readable_iovecs(iov);
+    std::string joined;
+    for (size_t i = 0; i < count; ++i)
+    {
+        assert(iov[i].iov_len > 0);
+        joined.append(static_cast<const char*>(iov[i].iov_base), iov[i].iov_len);
+    }
+    assert(joined == model);
+
+    std::string copied(model.size(), '\0');
+    assert(buffer.copy_to(0, copied.data(), copied.size()) == model.size());
+    assert(copied == model);
+
+    std::string appended = "prefix";
+    buffer.append_to(0, model.size(), appended);
+    assert(appended == "prefix" + model);
+}
+
+// 通过 writable_iovecs 写入 data，返回导出的 iovec 个数
+size_t write_iovecs(Buffer& buffer, const std::string& data, size_t reserve_size)
+{
+    std::array<iovec, 8> iov{};
+    size_t count = buffer.writable_iovecs(iov, reserve_size);
+    size_t written = 0;
+    for (size_t i = 0; i < count && written < data.size(); ++i)
+    {
+        size_t n = std::min(iov[i].iov_len, data.size() - written);
+        std::memcpy(iov[i].iov_base, data.data() + written, n);
+        written += n;
+    }
+    assert(written == data.size());
+    buffer.commit_write(data.size());
+    return count;
+}
+
+// ============================================================================
+// 测试1: 写满整段，边界恰好落在 BufferSegment::Size
+// ============================================================================
+void test_exact_segment()
+{
+    std::cout << "=== Test 1: Write Ending At Segment Size ===" << std::endl;
+
+    Pattern pattern;
+    Buffer buffer;
+    std::string model = pattern.take(Seg);
+    buffer.append(model);
+    check(buffer, model);
+    assert(buffer.front().size() == Seg);
+
+    // 段已写满，下一次写入必须换新段
+    auto span = buffer.writable_span(1);
+    assert(span.size() == 1);
+    auto more = pattern.take(1);
+    span[0] = more[0];
+    buffer.commit_write(1);
+    model += more;
+    check(buffer, model);
+    assert(buffer.front().size() == Seg);
+
+    // 经 writable_iovecs 恰好写到第二段末尾
+    Buffer exact;
+    std::string data = pattern.take(2 * Seg);
+    write_iovecs(exact, data, 2 * Seg);
+    check(exact, data);
+
+    // 消费恰好一整段，读位置回到下一段开头
+    exact.retrieve(Seg);
+    data.erase(0, Seg);
+    check(exact, data);
+    assert(exact.front().size() == Seg);
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试2: writable_iovecs 预挂空段，commit_write 只保留写到的段
+// ============================================================================
+void test_spare_segments()
+{
+    std::cout << "=== Test 2: Writable Iovecs Spare Segments ===" << std::endl;
+
+    Pattern pattern;
+    Buffer buffer;
+    std::string model = pattern.take(100);
+    buffer.append(model);
+
+    // 预挂三段以上，但只写到第二段中间
+    std::array<iovec, 8> iov{};
+    size_t count = buffer.writable_iovecs(iov, 3 * Seg);
+    assert(count == 4);
+    assert(iov[0].iov_len == Seg - 100);
+    for (size_t i = 1; i < count; ++i)
+    {
+        assert(iov[i].iov_len == Seg);
+    }
+    // 预挂的段不算可读数据
+    check(buffer, model);
+
+    auto data = pattern.take(Seg + 10);
+    size_t written = 0;
+    for (size_t i = 0; i < count && written < data.size(); ++i)
+    {
+        size_t n = std::min(iov[i].iov_len, data.size() - written);
+        std::memcpy(iov[i].iov_base, data.data() + written, n);
+        written += n;
+    }
+    buffer.commit_write(data.size());
+    model += data;
+    check(buffer, model);
+
+    // 未用上的段已经归还，下一次写入接着第二段继续
+    assert(buffer.writable_span(Seg).size() == Seg - 110);
+
+    // 什么都没写也要归还预挂段
+    count = buffer.writable_iovecs(iov, 2 * Seg);
+    assert(count == 3);
+    buffer.commit_write(0);
+    check(buffer, model);
+
+    // out 容量限制预挂段数
+    std::array<iovec, 2> small{};
+    assert(buffer.writable_iovecs(small, 10 * Seg) == 2);
+    buffer.commit_write(0);
+    check(buffer, model);
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试3: retrieve 跨越段边界
+// ============================================================================
+void test_retrieve_across_segments()
+{
+    std::cout << "=== Test 3: Retrieve Across Segments ===" << std::endl;
+
+    Pattern pattern;
+    Buffer buffer;
+    std::string model = pattern.take(3 * Seg + 123);
+    buffer.append(model);
+    check(buffer, model);
+
+    for (size_t bytes : {Seg - 1, size_t{2}, Seg + 7, size_t{1}})
+    {
+        buffer.retrieve(bytes);
+        model.erase(0, bytes);
+        check(buffer, model);
+    }
+
+    // 读空后复用同一个 Buffer
+    buffer.retrieve(model.size());
+    model.clear();
+    check(buffer, model);
+    model = pattern.take(Seg + 1);
+    buffer.append(model);
+    check(buffer, model);
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试4: copy_to / append_to / readable_iovecs 跨段读取任意区间
+// ============================================================================
+void test_ranges_across_segments()
+{
+    std::cout << "=== Test 4: Ranges Across Segments ===" << std::endl;
+
+    Pattern pattern;
+    Buffer buffer;
+    std::string model = pattern.take(3 * Seg + 50);
+    buffer.append(model);
+    // 读位置不在段开头
+    buffer.retrieve(300);
+    model.erase(0, 300);
+
+    std::array<iovec, 8> iov{};
+    assert(buffer.readable_iovecs(iov) == 4);
+    assert(iov[0].iov_len == Seg - 300);
+    assert(iov[3].iov_len == 50);
+    // out 容量不够时只导出前几段
+    std::array<iovec, 2> small{};
+    assert(buffer.readable_iovecs(small) == 2);
+    assert(small[1].iov_len == Seg);
+
+    size_t size = model.size();
+    for (size_t offset : {size_t{0}, Seg - 301, Seg - 300, 2 * Seg, size - 1})
+    {
+        for (size_t len : {size_t{1}, size_t{600}, Seg + 1, 2 * Seg + 5})
+        {
+            auto expected = model.substr(offset, len);
+
+            std::string copied(len, '\0');
+            assert(buffer.copy_to(offset, copied.data(), len) == expected.size());
+            copied.resize(expected.size());
+            assert(copied == expected);
+
+            std::string appended;
+            buffer.append_to(offset, len, appended);
+            assert(appended == expected);
+        }
+    }
+    // 越过末尾不拷贝
+    char c = 0;
+    assert(buffer.copy_to(size, &c, 1) == 0);
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试5: 随机操作序列与 std::string 模型对比
+// ============================================================================
+void test_random_against_model()
+{
+    std::cout << "=== Test 5: Random Operations Against Model ===" << std::endl;
+
+    std::mt19937 rng(20240601);
+    Pattern pattern;
+    Buffer buffer;
+    std::string model;
+    for (int round = 0; round < 20000; ++round)
+    {
+        switch (rng() % 4)
+        {
+        case 0: {
+            // 写入量可能小于、等于或跨越准备好的空间
+            size_t reserve = rng() % (3 * Seg);
+            std::array<iovec, 8> iov{};
+            size_t count = buffer.writable_iovecs(iov, reserve);
+            size_t capacity = 0;
+            for (size_t i = 0; i < count; ++i)
+            {
+                capacity += iov[i].iov_len;
+            }
+            auto data = pattern.take(rng() % 2 ? capacity : rng() % (capacity + 1));
+            size_t written = 0;
+            for (size_t i = 0; i < count && written < data.size(); ++i)
+            {
+                size_t n = std::min(iov[i].iov_len, data.size() - written);
+                std::memcpy(iov[i].iov_base, data.data() + written, n);
+                written += n;
+            }
+            buffer.commit_write(data.size());
+            model += data;
+            break;
+        }
+        case 1: {
+            auto data = pattern.take(rng() % (Seg + Seg / 2));
+            buffer.append(data);
+            model += data;
+            break;
+        }
+        case 2: {
+            size_t bytes = model.empty() ? 0 : rng() % (model.size() + 1);
+            buffer.retrieve(bytes);
+            model.erase(0, bytes);
+            break;
+        }
+        default: {
+            if (model.empty())
+            {
+                break;
+            }
+            size_t offset = rng() % model.size();
+            size_t len = rng() % (model.size() - offset + 1);
+            std::string out;
+            buffer.append_to(offset, len, out);
+            assert(out == model.substr(offset, len));
+            break;
+        }
+        }
+        if (model.size() > 32 * Seg)
+        {
+            buffer.retrieve(model.size() - Seg);
+            model.erase(0, model.size() - Seg);
+        }
+        check(buffer, model);
+    }
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试6: P 不再借还段后，缓存仍由定时回收释放
+// ============================================================================
+auto test_idle_trim() -> Coroutine<>
+{
+    std::cout << "=== Test 6: Idle Processor Trims Cache ===" << std::endl;
+
+    auto id = current_processor();
+    assert(id >= 0);
+    SegmentPool::set_idle_release(std::chrono::milliseconds(10));
+    {
+        Buffer buffer;
+        buffer.append(Pattern().take(8 * Seg));
+    }
+    assert(SegmentPool::stats()[id].cached >= 8);
+
+    // 期间不再访问缓存，只靠定时回收
+    for (int i = 0; i < 100 && SegmentPool::stats()[id].cached > 0; ++i)
+    {
+        co_await delay(std::chrono::milliseconds(10));
+    }
+    assert(SegmentPool::stats()[id].cached == 0);
+    SegmentPool::set_idle_release(std::chrono::milliseconds(1000));
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 主协程：运行所有测试
+// ============================================================================
+auto main_coro() -> MainCoroutine
+{
+    std::cout << "========================================" << std::endl;
+    std::cout << "      Buffer Test Suite                 " << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    test_exact_segment();
+    std::cout << std::endl;
+
+    test_spare_segments();
+    std::cout << std::endl;
+
+    test_retrieve_across_segments();
+    std::cout << std::endl;
+
+    test_ranges_across_segments();
+    std::cout << std::endl;
+
+    test_random_against_model();
+    std::cout << std::endl;
+
+    // 所有段都已归还
+    assert(SegmentPool::in_use() == 0);
+
+    co_await test_idle_trim();
+    std::cout << std::endl;
+
+    std::cout << "========================================" << std::endl;
+    std::cout << "   All Tests PASSED!   " << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    co_return 0;
+}
+
+} // namespace utils
@@ -0,0 +1,189 @@
+#include "coroutine/main.h"
+#include "coroutine/syscall.h"
+#include "tcp/sendqueue.h"
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace utils
+{
+
+// 每条消息 30 字节：排队 4 条后达到高水位，降到 1 条才放行
+constexpr SendQueueLimits limits{.high_watermark = 100, .low_watermark = 40};
+
+auto message(const std::string& tag) -> std::string
+{
+    auto data = tag;
+    data.resize(30, '.');
+    return data;
+}
+
+struct Producer
+{
+    std::atomic<bool> done{false};
+    State state{State::CLOSED};
+};
+
+// done 是生产者最后访问的状态，置位后测试可以立即销毁 producer
+auto produce(SendQueue& queue, std::string data, Producer& producer) -> Coroutine<>
+{
+    producer.state = co_await queue.push(std::move(data));
+    producer.done.store(true, std::memory_order_release);
+}
+
+// 留出时间让刚派发的生产者运行到挂起点或被放行后的返回点
+auto settle() { return delay(std::chrono::milliseconds(20)); }
+
+auto pop_one(SendQueue& queue) -> Coroutine<std::string>
+{
+    std::vector<std::string> out;
+    auto state = co_await queue.pop(out, 1, SIZE_MAX);
+    assert(state == State::OK);
+    assert(out.size() == 1);
+    co_return std::move(out.front());
+}
+
+// ============================================================================
+// 测试1: 高水位挂起生产者，降到低水位以下后按 FIFO 放行
+// ============================================================================
+auto test_watermarks() -> Coroutine<>
+{
+    std::cout << "=== Test 1: Watermarks And FIFO Admission ===" << std::endl;
+
+    SendQueue queue(limits);
+    // 未达到高水位时立即返回，第 4 条把队列推过高水位
+    for (int i = 0; i < 4; ++i)
+    {
+        assert(co_await queue.push(message("m" + std::to_string(i))) == State::OK);
+    }
+    assert(queue.queued_bytes() == 120);
+
+    std::array<Producer, 5> producers;
+    for (int i = 0; i < 4; ++i)
+    {
+        // 逐个派发，保证挂起顺序就是编号顺序
+        co_spawn(produce(queue, message("p" + std::to_string(i)), producers[i]));
+        co_await settle();
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+        assert(!producers[i].done.load(std::memory_order_acquire));
+    }
+    assert(queue.queued_bytes() == 120);
+
+    // 降到高水位以下但仍高于低水位：不放行，新来的生产者也要排在后面
+    assert(co_await pop_one(queue) == message("m0"));
+    assert(queue.queued_bytes() == 90);
+    co_spawn(produce(queue, message("late"), producers[4]));
+    co_await settle();
+    for (auto& producer : producers)
+    {
+        assert(!producer.done.load(std::memory_order_acquire));
+    }
+    assert(co_await pop_one(queue) == message("m1"));
+    assert(queue.queued_bytes() == 60);
+    co_await settle();
+    assert(!producers[0].done.load(std::memory_order_acquire));
+
+    // 降到低水位：按顺序放行，直到再次达到高水位
+    assert(co_await pop_one(queue) == message("m2"));
+    co_await settle();
+    assert(queue.queued_bytes() == 120);
+    for (int i = 0; i < 3; ++i)
+    {
+        assert(producers[i].done.load(std::memory_order_acquire));
+        assert(producers[i].state == State::OK);
+    }
+    assert(!producers[3].done.load(std::memory_order_acquire));
+    assert(!producers[4].done.load(std::memory_order_acquire));
+
+    // 消息按入队顺序取出，被放行的生产者排在已有消息之后
+    std::vector<std::string> expected{message("m3"), message("p0"), message("p1"), message("p2"), message("p3"),
+                                      message("late")};
+    for (const auto& data : expected)
+    {
+        assert(co_await pop_one(queue) == data);
+    }
+    co_await settle();
+    for (auto& producer : producers)
+    {
+        assert(producer.done.load(std::memory_order_acquire));
+        assert(producer.state == State::OK);
+    }
+    assert(queue.queued_bytes() == 0);
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试2: close 以 CLOSED 唤醒挂起的生产者
+// ============================================================================
+auto test_close_wakes_producers() -> Coroutine<>
+{
+    std::cout << "=== Test 2: Close Wakes Parked Producers ===" << std::endl;
+
+    SendQueue queue(limits);
+    for (int i = 0; i < 4; ++i)
+    {
+        assert(co_await queue.push(message("m" + std::to_string(i))) == State::OK);
+    }
+
+    std::array<Producer, 3> producers;
+    for (int i = 0; i < 3; ++i)
+    {
+        co_spawn(produce(queue, message("p" + std::to_string(i)), producers[i]));
+    }
+    co_await settle();
+    for (auto& producer : producers)
+    {
+        assert(!producer.done.load(std::memory_order_acquire));
+    }
+
+    queue.close();
+    co_await settle();
+    for (auto& producer : producers)
+    {
+        assert(producer.done.load(std::memory_order_acquire));
+        assert(producer.state == State::CLOSED);
+    }
+    // 被拒绝的消息不入队
+    assert(queue.queued_bytes() == 120);
+
+    // 关闭后 push 立即失败，已排队的消息仍可取完
+    assert(co_await queue.push(message("after")) == State::CLOSED);
+    std::vector<std::string> out;
+    assert(co_await queue.pop(out, SIZE_MAX, SIZE_MAX) == State::OK);
+    assert(out.size() == 4);
+    assert(co_await queue.pop(out, SIZE_MAX, SIZE_MAX) == State::CLOSED);
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 主协程：运行所有测试
+// ============================================================================
+auto main_coro() -> MainCoroutine
+{
+    std::cout << "========================================" << std::endl;
+    std::cout << "      SendQueue Test Suite              " << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    co_await test_watermarks();
+    std::cout << std::endl;
+
+    co_await test_close_wakes_producers();
+    std::cout << std::endl;
+
+    std::cout << "========================================" << std::endl;
+    std::cout << "   All Tests PASSED!   " << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    co_return 0;
+}
+
+} // namespace utils
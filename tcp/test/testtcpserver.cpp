@@ -0,0 +1,163 @@
+#include "coroutine/main.h"
+#include "coroutine/syscall.h"
+#include "tcp/tcpserver.h"
+#include <array>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace utils
+{
+
+// 连接一直保持到客户端关闭
+auto hold_until_closed(Socket socket) -> Coroutine<>
+{
+    std::array<char, 64> data;
+    while (co_await socket.recv(data) > 0)
+    {
+    }
+}
+
+// 留出时间让 accept 循环和连接协程处理完已到达的事件
+auto settle() { return delay(std::chrono::milliseconds(50)); }
+
+// 内核在 listen 队列里完成握手，服务器暂停 accept 时 connect 也会成功
+auto connect_clients(const InetAddress& addr, size_t count) -> Coroutine<std::vector<Socket>>
+{
+    std::vector<Socket> clients;
+    for (size_t i = 0; i < count; ++i)
+    {
+        clients.push_back(Socket::create_tcp());
+        assert(co_await clients.back().connect(addr) == 0);
+    }
+    co_return clients;
+}
+
+// ============================================================================
+// 测试1: 满载时暂停 accept，活跃连接降到恢复水位后继续
+// ============================================================================
+auto test_pause_resume() -> Coroutine<>
+{
+    std::cout << "=== Test 1: Pause And Resume Accept ===" << std::endl;
+
+    InetAddress addr(9611, "127.0.0.1");
+    // accept 循环不会退出，服务器对象保留到进程结束
+    static TcpServer server(addr);
+    server.set_connection_handler(hold_until_closed);
+    // 恢复水位不小于上限时按上限的 90% 取值，这里为 2
+    server.set_connection_limits({.max_connections = 3, .resume_connections = 3});
+    co_spawn(server.start());
+    co_await settle();
+
+    auto clients = co_await connect_clients(addr, 5);
+    co_await settle();
+    auto stats = server.connection_stats();
+    assert(stats.accepted == 3);
+    assert(stats.active == 3);
+    assert(stats.rejected == 0);
+    // 暂停期间 accept 循环挂起，不会反复进出暂停
+    assert(stats.paused >= 1 && stats.paused <= 2);
+    co_await settle();
+    assert(server.connection_stats().paused == stats.paused);
+
+    // 活跃连接降到 2 时恢复，接受一条后再次满载
+    clients[0].close();
+    co_await settle();
+    stats = server.connection_stats();
+    assert(stats.accepted == 4);
+    assert(stats.active == 3);
+
+    clients[1].close();
+    co_await settle();
+    stats = server.connection_stats();
+    assert(stats.accepted == 5);
+    assert(stats.active == 3);
+    assert(stats.rejected == 0);
+
+    for (auto& client : clients)
+    {
+        client.close();
+    }
+    co_await settle();
+    assert(server.connection_stats().active == 0);
+
+    std::cout << "  Paused: " << server.connection_stats().paused << std::endl;
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 测试2: reject_when_full 时满载的连接被立即以 RST 关闭
+// ============================================================================
+auto test_reject_when_full() -> Coroutine<>
+{
+    std::cout << "=== Test 2: Reject When Full ===" << std::endl;
+
+    InetAddress addr(9612, "127.0.0.1");
+    static TcpServer server(addr);
+    server.set_connection_handler(hold_until_closed);
+    server.set_connection_limits({.max_connections = 2, .reject_when_full = true});
+    co_spawn(server.start());
+    co_await settle();
+
+    auto clients = co_await connect_clients(addr, 5);
+    co_await settle();
+    auto stats = server.connection_stats();
+    assert(stats.accepted == 2);
+    assert(stats.rejected == 3);
+    assert(stats.active == 2);
+    assert(stats.paused == 0);
+
+    // 前两条连接仍然保持，其余的收到 RST
+    std::array<char, 8> data;
+    for (size_t i = 2; i < clients.size(); ++i)
+    {
+        assert(co_await clients[i].recv(data) == -ECONNRESET);
+    }
+
+    // 名额空出后新连接可以被接受
+    clients[0].close();
+    co_await settle();
+    auto more = co_await connect_clients(addr, 1);
+    co_await settle();
+    stats = server.connection_stats();
+    assert(stats.accepted == 3);
+    assert(stats.rejected == 3);
+    assert(stats.active == 2);
+
+    for (auto& client : clients)
+    {
+        client.close();
+    }
+    more[0].close();
+    co_await settle();
+    assert(server.connection_stats().active == 0);
+
+    std::cout << "PASSED" << std::endl;
+}
+
+// ============================================================================
+// 主协程：运行所有测试
+// ============================================================================
+auto main_coro() -> MainCoroutine
+{
+    std::cout << "========================================" << std::endl;
+    std::cout << "      TcpServer Test Suite              " << std::endl;
+    std::cout << "========================================" << std::endl;
+    std::cout << std::endl;
+
+    co_await test_pause_resume();
+    std::cout << std::endl;
+
+    co_await test_reject_when_full();
+    std::cout << std::endl;
+
+    std::cout << "========================================" << std::endl;
+    std::cout << "   All Tests PASSED!   " << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    co_return 0;
+}
+
+} // namespace utils
@@ -0,0 +1,186 @@
+#include "coroutine/coroutine.h"
+#include "coroutine/main.h"
+#include "coroutine/syscall.h"
+#include "coroutine/waitgroup.h"
+#include "tcp/inetaddress.h"
+#include "tcp/udpsocket.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// 回环上的 UDP 包量测试，对比三种收发方式：
+//   single：每个报文一次 recvmsg/sendmsg
+//   mmsg  ：recvmmsg/sendmmsg 每次批量收发 batch_size 个报文
+//   gso   ：发送端用 UDP_SEGMENT 一次交给内核 batch_size 个报文，接收端开启 UDP_GRO
+
+using namespace std::chrono;
+
+namespace utils
+{
+constexpr uint16_t base_port = 9200;
+constexpr size_t payload_size = 64;
+constexpr size_t batch_size = 64;
+constexpr int sender_count = 4;
+constexpr auto test_duration = seconds(2);
+
+enum class Mode
+{
+    SINGLE,
+    MMSG,
+    GSO,
+};
+
+struct Counters
+{
+    std::atomic<uint64_t> sent{0};
+    std::atomic<uint64_t> received{0};
+    std::atomic<bool> stop{false};
+};
+
+auto receiver(UdpSocket& socket, Mode mode, Counters& counters, WaitGroup& wg) -> Coroutine<>
+{
+    DoneGuard guard(wg);
+    if (mode == Mode::SINGLE)
+    {
+        std::array<char, 2048> buffer;
+        InetAddress from;
+        while (!counters.stop.load(std::memory_order_relaxed))
+        {
+            if (co_await socket.recv_from(buffer, from) < 0)
+            {
+                co_return;
+            }
+            counters.received.fetch_add(1, std::memory_order_relaxed);
+        }
+        co_return;
+    }
+
+    // GRO 合并后的报文最大 64KB
+    UdpBatch batch(batch_size, mode == Mode::GSO ? 65536 : 2048);
+    while (!counters.stop.load(std::memory_order_relaxed))
+    {
+        int n = co_await socket.recv_batch(batch);
+        if (n < 0)
+        {
+            co_return;
+        }
+        uint64_t packets = 0;
+        for (int i = 0; i < n; ++i)
+        {
+            auto segment = batch.segment_size(i);
+            packets += segment > 0 ? (batch.data(i).size() + segment - 1) / segment : 1;
+        }
+        counters.received.fetch_add(packets, std::memory_order_relaxed);
+    }
+}
+
+auto sender(InetAddress target, Mode mode, Counters& counters, WaitGroup& wg) -> Coroutine<>
+{
+    DoneGuard guard(wg);
+    auto socket = UdpSocket::create();
+    socket.connect(target);
+    socket.set_buffer_size(4 << 20);
+    std::string payload(payload_size, 'x');
+    auto deadline = steady_clock::now() + test_duration;
+
+    if (mode == Mode::SINGLE)
+    {
+        while (steady_clock::now() < deadline)
+        {
+            if (co_await socket.send(payload) < 0)
+            {
+                co_return;
+            }
+            counters.sent.fetch_add(1, std::memory_order_relaxed);
+        }
+        co_return;
+    }
+
+    UdpBatch batch(batch_size, payload_size * batch_size);
+    if (mode == Mode::MMSG)
+    {
+        for (size_t i = 0; i < batch_size; ++i)
+        {
+            batch.push(payload);
+        }
+    }
+    else
+    {
+        // 一个 GSO 缓冲区由内核切成 batch_size 个报文
+        std::string segments(payload_size * batch_size, 'x');
+        batch.push(segments, nullptr, payload_size);
+    }
+    while (steady_clock::now() < deadline)
+    {
+        int n = co_await socket.send_batch(batch);
+        if (n <= 0)
+        {
+            co_return;
+        }
+        // GSO 模式下每个报文槽位含 batch_size 个报文
+        counters.sent.fetch_add(mode == Mode::MMSG ? n : n * batch_size, std::memory_order_relaxed);
+        // 回环上 sendmmsg 几乎不会阻塞，主动让出，避免在 P 较少时饿死接收端
+        co_yield {};
+    }
+}
+
+auto run_mode(const char* name, Mode mode, uint16_t port) -> Coroutine<>
+{
+    InetAddress addr(port, "127.0.0.1");
+    auto socket = UdpSocket::create();
+    socket.bind(addr);
+    socket.set_buffer_size(16 << 20);
+    if (mode == Mode::GSO && !socket.set_gro(true))
+    {
+        std::cout << std::left << std::setw(8) << name << "UDP_GRO not supported, skipped" << std::endl;
+        co_return;
+    }
+
+    Counters counters;
+    WaitGroup receiver_wg;
+    receiver_wg.add(1);
+    co_spawn(receiver(socket, mode, counters, receiver_wg));
+
+    auto start = steady_clock::now();
+    WaitGroup sender_wg;
+    sender_wg.add(sender_count);
+    for (int i = 0; i < sender_count; ++i)
+    {
+        co_spawn(sender(addr, mode, counters, sender_wg));
+    }
+    co_await sender_wg.wait();
+    double duration_s = duration_cast<microseconds>(steady_clock::now() - start).count() / 1e6;
+    auto received = counters.received.load();
+
+    // 再发一个报文唤醒仍在等待的接收端
+    counters.stop.store(true);
+    auto waker = UdpSocket::create();
+    co_await waker.send_to(std::string_view("x"), addr);
+    co_await receiver_wg.wait();
+
+    auto sent = counters.sent.load();
+    double loss = sent == 0 ? 0.0 : 100.0 * (sent > received ? sent - received : 0) / sent;
+    std::cout << std::left << std::setw(8) << name << std::right << std::fixed << std::setprecision(0) << std::setw(14)
+              << sent / duration_s << std::setw(14) << received / duration_s << std::setw(10) << std::setprecision(1)
+              << loss << std::endl;
+}
+
+auto main_coro() -> MainCoroutine
+{
+    std::cout << "UDP loopback, payload " << payload_size << "B, " << sender_count << " senders, batch " << batch_size
+              << std::endl;
+    std::cout << std::left << std::setw(8) << "Mode" << std::right << std::setw(14) << "Sent pps" << std::setw(14)
+              << "Recv pps" << std::setw(10) << "Loss(%)" << std::endl;
+    std::cout << std::string(46, '-') << std::endl;
+
+    co_await run_mode("single", Mode::SINGLE, base_port);
+    co_await run_mode("mmsg", Mode::MMSG, base_port + 1);
+    co_await run_mode("gso", Mode::GSO, base_port + 2);
+    co_return 0;
+}
+} // namespace utils